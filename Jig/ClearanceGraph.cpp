@@ -0,0 +1,298 @@
+#include "ClearanceGraph.h"
+#include "EdgeMeshVisibility.h"
+#include "Geometry.h"
+#include "GetVisiblePoints.h"
+#include "IndexedHeap.h"
+#include "Mitre.h"
+#include "ThreadPool.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Jig;
+
+namespace
+{
+	const double Unreachable = std::numeric_limits<double>::max();
+	const double Tolerance = 1e-6; // Of radius. Corners are exactly radius from their own walls.
+	const int MaxGridSize = 1024; // Cells across.
+
+	// Lines that don't cross: the nearest points include an end point.
+	double GetDistanceSquared(const Vec2& a0, const Vec2& a1, const Vec2& b0, const Vec2& b1)
+	{
+		using Geometry::GetDistanceSquared;
+		return std::min({ GetDistanceSquared(a0, b0, b1), GetDistanceSquared(a1, b0, b1), GetDistanceSquared(b0, a0, a1), GetDistanceSquared(b1, a0, a1) });
+	}
+}
+
+ClearanceGraph::ClearanceGraph(const EdgeMesh& mesh, double radius) : m_mesh(mesh), m_radius(radius)
+{
+	KERNEL_ASSERT(radius > 0 && EdgeMeshVisibility::HasData(m_mesh));
+
+	AddWalls();
+	AddNodes();
+
+	// Links are between corners whose verts can see each other.
+	ThreadPool::GetDefault().ParallelFor(m_nodes.size(), [&](size_t i)
+	{
+		Node& node = m_nodes[i];
+		GetLinks(node.point, EdgeMeshVisibility::GetData(node.vert)->visible, node.links);
+	});
+}
+
+ClearanceGraph::~ClearanceGraph()
+{
+}
+
+// About one wall per cell. A wall is listed in every cell its bbox touches.
+void ClearanceGraph::AddWalls()
+{
+	RectGrower grower;
+	for (auto& face : m_mesh.GetFaces())
+		for (auto& edge : face->GetEdges())
+			if (!edge.twin)
+			{
+				Rect bbox(*edge.vert, *edge.next->vert);
+				bbox.Normalise();
+				m_walls.push_back(Wall{ *edge.vert, *edge.next->vert, bbox });
+				grower.Add(bbox);
+			}
+
+	const Rect& bbox = grower.GetRect();
+	const double area = bbox.Width() * bbox.Height();
+	m_gridOrigin = bbox.m_p0;
+	m_cellSize = area > 0 ? std::sqrt(area / m_walls.size()) : std::max({ bbox.Width(), bbox.Height(), 1.0 });
+	m_gridWidth = std::min(MaxGridSize, (int)(bbox.Width() / m_cellSize) + 1);
+	m_gridHeight = std::min(MaxGridSize, (int)(bbox.Height() / m_cellSize) + 1);
+
+	// Count, then fill.
+	auto forEachCell = [&](const Rect& rect, auto&& fn)
+	{
+		for (int y = GetCellY(rect.m_p0.y), y1 = GetCellY(rect.m_p1.y); y <= y1; ++y)
+			for (int x = GetCellX(rect.m_p0.x), x1 = GetCellX(rect.m_p1.x); x <= x1; ++x)
+				fn(y * m_gridWidth + x);
+	};
+
+	m_cellOffsets.assign(m_gridWidth * m_gridHeight + 1, 0);
+	for (auto& wall : m_walls)
+		forEachCell(wall.bbox, [&](int cell) { ++m_cellOffsets[cell + 1]; });
+	for (size_t i = 1; i < m_cellOffsets.size(); ++i)
+		m_cellOffsets[i] += m_cellOffsets[i - 1];
+
+	std::vector<uint32_t> ends(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+	m_cellWalls.resize(m_cellOffsets.back());
+	for (uint32_t i = 0; i < m_walls.size(); ++i)
+		forEachCell(m_walls[i].bbox, [&](int cell) { m_cellWalls[ends[cell]++] = i; });
+}
+
+int ClearanceGraph::GetCellX(double x) const
+{
+	return std::clamp((int)std::floor((x - m_gridOrigin.x) / m_cellSize), 0, m_gridWidth - 1);
+}
+
+int ClearanceGraph::GetCellY(double y) const
+{
+	return std::clamp((int)std::floor((y - m_gridOrigin.y) / m_cellSize), 0, m_gridHeight - 1);
+}
+
+// Only reflex corners can be on a shortest path.
+void ClearanceGraph::AddNodes()
+{
+	m_vertNodes.assign(m_mesh.GetVerts().size(), {});
+
+	for (auto& face : m_mesh.GetFaces())
+		for (auto& edge : face->GetEdges())
+		{
+			const EdgeMesh::Edge* nextEdge = edge.twin ? nullptr : edge.FindNextOuterEdge();
+			if (!nextEdge)
+				continue;
+
+			// Faces are CCW, so walls turn right at reflex corners.
+			const Vec2& prev = *edge.vert;
+			const EdgeMesh::Vert& vert = *edge.next->vert;
+			const Vec2& next = *nextEdge->next->vert;
+			if (Vec2(vert - prev).DotSine(next - vert) >= 0)
+				continue;
+
+			const auto mitre = GetMitreVec<double>(vert, &prev, &next, m_radius);
+			if (!mitre)
+				continue;
+
+			const Vec2 point = vert - *mitre; // Mitre points into the wall.
+			if (!m_mesh.HitTest(point) || !IsClear(point, point)) // Corner of a gap narrower than 2 * radius.
+				continue;
+
+			m_vertNodes[vert.GetIndex()].push_back((int)m_nodes.size());
+			m_nodes.push_back(Node{ point, &vert, {} });
+		}
+}
+
+void ClearanceGraph::GetLinks(const Vec2& point, const std::vector<const EdgeMesh::Vert*>& visible, std::vector<Link>& links) const
+{
+	links.clear();
+	for (auto* vert : visible)
+		for (int node : m_vertNodes[vert->GetIndex()])
+		{
+			const Vec2& nodePoint = m_nodes[node].point;
+			if (!(nodePoint == point) && IsClear(point, nodePoint))
+				links.push_back(Link{ node, Vec2(nodePoint - point).GetLength() });
+		}
+}
+
+bool ClearanceGraph::IsClear(const Vec2& point0, const Vec2& point1) const
+{
+	if (!IsVisible(m_mesh, point0, point1))
+		return false;
+
+	Rect bbox(point0, point1);
+	bbox.Normalise();
+	bbox.Inflate(m_radius, m_radius);
+
+	// Row by row, only the cells the line passes within radius of. Walls in more than one cell can be
+	// tested more than once, which is cheaper than keeping track.
+	const double minLength = m_radius * (1 - Tolerance);
+	const Vec2 vec = point1 - point0;
+	for (int y = GetCellY(bbox.m_p0.y), y1 = GetCellY(bbox.m_p1.y); y <= y1; ++y)
+	{
+		double x0 = bbox.m_p0.x, x1 = bbox.m_p1.x;
+		if (vec.y != 0) // Clip the line to the row, widened by radius. Edge rows hold everything beyond the grid.
+		{
+			const double rowY0 = y > 0 ? m_gridOrigin.y + y * m_cellSize - m_radius : bbox.m_p0.y;
+			const double rowY1 = y < m_gridHeight - 1 ? m_gridOrigin.y + (y + 1) * m_cellSize + m_radius : bbox.m_p1.y;
+			const double t0 = std::clamp((rowY0 - point0.y) / vec.y, 0.0, 1.0), t1 = std::clamp((rowY1 - point0.y) / vec.y, 0.0, 1.0);
+			const double clipX0 = point0.x + vec.x * t0, clipX1 = point0.x + vec.x * t1;
+			x0 = std::max(x0, std::min(clipX0, clipX1) - m_radius);
+			x1 = std::min(x1, std::max(clipX0, clipX1) + m_radius);
+		}
+
+		for (int x = GetCellX(x0), cellX1 = GetCellX(x1); x <= cellX1; ++x)
+		{
+			const int cell = y * m_gridWidth + x;
+			for (uint32_t i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i)
+			{
+				const Wall& wall = m_walls[m_cellWalls[i]];
+				if (wall.bbox.Intersects(bbox) && GetDistanceSquared(point0, point1, wall.p0, wall.p1) < minLength * minLength)
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool ClearanceGraph::GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length) const
+{
+	path.clear();
+
+	if (!m_mesh.HitTest(startPoint) || !m_mesh.HitTest(endPoint) || !IsClear(startPoint, startPoint) || !IsClear(endPoint, endPoint))
+		return false;
+
+	if (IsClear(startPoint, endPoint))
+	{
+		path = { endPoint, startPoint };
+		if (length)
+			*length = Vec2(endPoint - startPoint).GetLength();
+		return true;
+	}
+
+	std::vector<Link> startLinks, endLinks;
+	GetLinks(startPoint, GetVisiblePoints(m_mesh, startPoint), startLinks);
+	GetLinks(endPoint, GetVisiblePoints(m_mesh, endPoint), endLinks);
+
+	const size_t nodeCount = m_nodes.size();
+	std::vector<double> nodeLengths(nodeCount, Unreachable), endLengths(nodeCount, Unreachable);
+	std::vector<int> prevNodes(nodeCount, -1);
+
+	for (auto& link : endLinks)
+		endLengths[link.node] = link.length;
+
+	IndexedHeap<double> queue;
+	queue.Reset(nodeCount);
+
+	auto relax = [&](int node, int prev, double nodeLength)
+	{
+		if (nodeLength < nodeLengths[node])
+		{
+			nodeLengths[node] = nodeLength;
+			prevNodes[node] = prev;
+			queue.PushOrDecrease(node, nodeLength + Vec2(endPoint - m_nodes[node].point).GetLength());
+		}
+	};
+
+	for (auto& link : startLinks)
+		relax(link.node, -1, link.length);
+
+	double bestLength = Unreachable;
+	int bestNode = -1;
+
+	while (!queue.IsEmpty() && queue.GetTop().key < bestLength)
+	{
+		const int node = queue.Pop().index;
+
+		if (endLengths[node] != Unreachable && nodeLengths[node] + endLengths[node] < bestLength)
+		{
+			bestLength = nodeLengths[node] + endLengths[node];
+			bestNode = node;
+		}
+
+		for (auto& link : m_nodes[node].links)
+			relax(link.node, node, nodeLengths[node] + link.length);
+	}
+
+	if (bestNode < 0)
+		return false;
+
+	path.push_back(endPoint);
+	for (int node = bestNode; node >= 0; node = prevNodes[node])
+		path.push_back(m_nodes[node].point);
+	path.push_back(startPoint);
+
+	if (length)
+		*length = bestLength;
+	return true;
+}
+
+ClearanceGraphCache::ClearanceGraphCache(const EdgeMesh& mesh, double radiusStep) : m_mesh(mesh), m_radiusStep(radiusStep), m_version(mesh.GetVersion())
+{
+	KERNEL_ASSERT(radiusStep > 0);
+}
+
+ClearanceGraphCache::~ClearanceGraphCache()
+{
+}
+
+const ClearanceGraph& ClearanceGraphCache::Get(double radius)
+{
+	if (m_mesh.GetVersion() != m_version)
+	{
+		Clear();
+		m_version = m_mesh.GetVersion();
+	}
+
+	const int radiusClass = GetClass(radius);
+	auto& graph = m_graphs[radiusClass];
+	if (!graph)
+		graph = std::make_unique<ClearanceGraph>(m_mesh, radiusClass * m_radiusStep);
+
+	return *graph;
+}
+
+double ClearanceGraphCache::GetClassRadius(double radius) const
+{
+	return GetClass(radius) * m_radiusStep;
+}
+
+// Within Tolerance of a step counts as on it, as IsClear() allows, so rounding error doesn't add a class.
+int ClearanceGraphCache::GetClass(double radius) const
+{
+	KERNEL_ASSERT(radius > 0);
+	return std::max(1, (int)std::ceil(radius * (1 - Tolerance) / m_radiusStep));
+}
+
+void ClearanceGraphCache::Clear()
+{
+	m_graphs.clear();
+}
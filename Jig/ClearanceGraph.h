@@ -0,0 +1,91 @@
+#pragma once
+
+#include "PathFinder.h"
+#include "Rect.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Jig
+{
+	// Visibility graph for round agents. Reflex corners are pushed out by the agent radius along
+	// their mitre, and links are only kept where the whole line stays at least radius from every
+	// wall, so gaps narrower than 2 * radius are never crossed. Needs EdgeMeshVisibility.
+	class ClearanceGraph
+	{
+	public:
+		ClearanceGraph(const EdgeMesh& mesh, double radius);
+		~ClearanceGraph();
+
+		double GetRadius() const { return m_radius; }
+		size_t GetNodeCount() const { return m_nodes.size(); }
+		const Vec2& GetNodePoint(size_t node) const { return m_nodes[node].point; }
+
+		bool IsClear(const Vec2& point0, const Vec2& point1) const; // Whole line at least radius from walls.
+
+		// Same order as PathFinder::GetPath(): end first. Start and end must be clear of walls too.
+		bool GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length = nullptr) const;
+
+	private:
+		struct Link
+		{
+			int node;
+			double length;
+		};
+
+		struct Node
+		{
+			Vec2 point;
+			const EdgeMesh::Vert* vert;
+			std::vector<Link> links;
+		};
+
+		struct Wall
+		{
+			Vec2 p0, p1;
+			Rect bbox;
+		};
+
+		void AddWalls();
+		void AddNodes();
+		int GetCellX(double x) const; // Clamped to the grid.
+		int GetCellY(double y) const;
+		void GetLinks(const Vec2& point, const std::vector<const EdgeMesh::Vert*>& visible, std::vector<Link>& links) const;
+
+		const EdgeMesh& m_mesh;
+		const double m_radius;
+		std::vector<Node> m_nodes;
+		std::vector<Wall> m_walls;
+
+		// Uniform grid of square cells over the walls, so IsClear() only tests walls near the line.
+		Vec2 m_gridOrigin;
+		double m_cellSize;
+		int m_gridWidth, m_gridHeight;
+		std::vector<uint32_t> m_cellOffsets; // Cell y * m_gridWidth + x has m_cellWalls[m_cellOffsets[cell]] up to the next cell's.
+		std::vector<uint32_t> m_cellWalls; // Walls' indices.
+		std::vector<std::vector<int>> m_vertNodes; // By vert index. More than one at pinch points.
+	};
+
+	// One ClearanceGraph per radius class, rebuilt when the mesh's version changes. Radii are rounded up
+	// to a multiple of radiusStep, so each class's graph is conservative for every radius in it.
+	class ClearanceGraphCache
+	{
+	public:
+		ClearanceGraphCache(const EdgeMesh& mesh, double radiusStep);
+		~ClearanceGraphCache();
+
+		double GetClassRadius(double radius) const; // The radius Get() builds the graph for.
+		const ClearanceGraph& Get(double radius);
+		void Clear();
+
+	private:
+		int GetClass(double radius) const;
+
+		const EdgeMesh& m_mesh;
+		const double m_radiusStep;
+		unsigned m_version;
+		std::map<int, std::unique_ptr<ClearanceGraph>> m_graphs; // By class.
+	};
+}
@@ -0,0 +1,288 @@
+#include "ContractionHierarchy.h"
+#include "EdgeMeshVisibility.h"
+#include "GetVisiblePoints.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace Jig;
+
+namespace
+{
+	const double Unreachable = std::numeric_limits<double>::max();
+	const int WitnessLimit = 200; // Verts settled per witness search. Fewer is quicker, but adds more shortcuts.
+}
+
+ContractionHierarchy::ContractionHierarchy(const EdgeMesh& mesh) : m_mesh(mesh), m_shortcutCount(0)
+{
+	KERNEL_ASSERT(EdgeMeshVisibility::HasData(m_mesh));
+	Contract();
+}
+
+ContractionHierarchy::~ContractionHierarchy()
+{
+}
+
+void ContractionHierarchy::AddArc(Arcs& arcs, int vert, double length, int middle)
+{
+	auto it = std::find_if(arcs.begin(), arcs.end(), [&](const Arc& arc) { return arc.vert == vert; });
+	if (it == arcs.end())
+		arcs.push_back(Arc{ vert, length, middle });
+	else if (length < it->length)
+		*it = Arc{ vert, length, middle };
+}
+
+// Lower priority is contracted first: few shortcuts for the arcs removed, and spread out.
+void ContractionHierarchy::Contract()
+{
+	const auto& verts = m_mesh.GetVerts();
+	const int count = (int)verts.size();
+
+	std::vector<Arcs> arcs(count); // Between verts not contracted yet.
+	for (auto& vert : verts)
+		for (auto* other : EdgeMeshVisibility::GetData(vert.get())->visible)
+			if (other != vert.get())
+			{
+				const double length = Vec2(*other - *vert).GetLength();
+				AddArc(arcs[vert->GetIndex()], other->GetIndex(), length, -1);
+				AddArc(arcs[other->GetIndex()], vert->GetIndex(), length, -1);
+			}
+
+	std::vector<bool> contracted(count);
+	std::vector<int> contractedNeighbours(count);
+	std::vector<double> witnessLengths(count, Unreachable);
+	auto getPriority = [&](int vert)
+	{
+		return ProcessVert(vert, arcs, contracted, witnessLengths, false) - (double)arcs[vert].size() + contractedNeighbours[vert];
+	};
+
+	IndexedHeap<double> queue;
+	queue.Reset(count);
+	for (int vert = 0; vert < count; ++vert)
+		queue.Push(vert, getPriority(vert));
+
+	m_upArcs.assign(count, {});
+	while (!queue.IsEmpty())
+	{
+		// Priorities only go stale, so recheck the top one before contracting it.
+		const int vert = queue.Pop().index;
+		const double priority = getPriority(vert);
+		if (!queue.IsEmpty() && priority > queue.GetTop().key)
+		{
+			queue.Push(vert, priority);
+			continue;
+		}
+
+		m_shortcutCount += ProcessVert(vert, arcs, contracted, witnessLengths, true);
+		contracted[vert] = true;
+
+		for (auto& arc : arcs[vert])
+		{
+			Arcs& otherArcs = arcs[arc.vert];
+			otherArcs.erase(std::find_if(otherArcs.begin(), otherArcs.end(), [&](const Arc& other) { return other.vert == vert; }));
+			++contractedNeighbours[arc.vert];
+		}
+		m_upArcs[vert] = std::move(arcs[vert]);
+	}
+}
+
+// Adds a shortcut between each pair of neighbours, unless a witness search finds a path as short
+// that doesn't go through vert.
+int ContractionHierarchy::ProcessVert(int vert, std::vector<Arcs>& arcs, const std::vector<bool>& contracted, std::vector<double>& lengths, bool add)
+{
+	const Arcs& neighbours = arcs[vert];
+	int shortcutCount = 0;
+
+	using QueueItem = std::pair<double, int>;
+	std::vector<int> touched; // To reset lengths.
+
+	for (size_t i = 0; i + 1 < neighbours.size(); ++i)
+	{
+		const Arc& in = neighbours[i];
+
+		double maxLength = 0;
+		for (size_t j = i + 1; j < neighbours.size(); ++j)
+			maxLength = std::max(maxLength, in.length + neighbours[j].length);
+
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+		for (int touchedVert : touched)
+			lengths[touchedVert] = Unreachable;
+		touched.assign(1, in.vert);
+		lengths[in.vert] = 0;
+		queue.push(QueueItem(0, in.vert));
+
+		for (int settled = 0; !queue.empty() && settled < WitnessLimit; ++settled)
+		{
+			const auto [length, witness] = queue.top();
+			queue.pop();
+			if (length > lengths[witness]) // Already done.
+				continue;
+			if (length > maxLength)
+				break;
+
+			for (auto& arc : arcs[witness])
+			{
+				if (arc.vert == vert || contracted[arc.vert])
+					continue;
+
+				const double nextLength = length + arc.length;
+				if (nextLength < lengths[arc.vert])
+				{
+					if (lengths[arc.vert] == Unreachable)
+						touched.push_back(arc.vert);
+					lengths[arc.vert] = nextLength;
+					queue.push(QueueItem(nextLength, arc.vert));
+				}
+			}
+		}
+
+		for (size_t j = i + 1; j < neighbours.size(); ++j)
+		{
+			const Arc& out = neighbours[j];
+			const double length = in.length + out.length;
+
+			if (lengths[out.vert] <= length)
+				continue;
+
+			++shortcutCount;
+			if (add)
+			{
+				AddArc(arcs[in.vert], out.vert, length, vert);
+				AddArc(arcs[out.vert], in.vert, length, vert);
+			}
+		}
+	}
+
+	for (int touchedVert : touched)
+		lengths[touchedVert] = Unreachable;
+
+	return shortcutCount;
+}
+
+int ContractionHierarchy::FindMiddle(int lower, int upper) const
+{
+	for (auto& arc : m_upArcs[lower])
+		if (arc.vert == upper)
+			return arc.middle;
+
+	KERNEL_ASSERT(false);
+	return -1;
+}
+
+// Appends the verts between from and to, in that order.
+void ContractionHierarchy::Unpack(int from, int to, int middle, std::vector<int>& verts) const
+{
+	if (middle < 0)
+		return;
+
+	Unpack(from, middle, FindMiddle(middle, from), verts);
+	verts.push_back(middle);
+	Unpack(middle, to, FindMiddle(middle, to), verts);
+}
+
+int ContractionHierarchy::Search(IndexedHeap<double>& queue, std::vector<SearchItem>& items, const Vec2& target, double bestLength) const
+{
+	const int vert = queue.Pop().index;
+	const double length = items[vert].length;
+	if (length + Vec2(target - *m_mesh.GetVerts()[vert]).GetLength() >= bestLength) // Can't lead to a shorter path.
+		return vert;
+
+	for (auto& arc : m_upArcs[vert])
+	{
+		SearchItem& item = items[arc.vert];
+		if (length + arc.length < item.length)
+		{
+			item = SearchItem{ length + arc.length, vert, arc.middle };
+			queue.PushOrDecrease(arc.vert, item.length);
+		}
+	}
+	return vert;
+}
+
+bool ContractionHierarchy::GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length) const
+{
+	path.clear();
+
+	if (IsVisible(m_mesh, startPoint, endPoint))
+	{
+		path = { endPoint, startPoint };
+		if (length)
+			*length = Vec2(endPoint - startPoint).GetLength();
+		return true;
+	}
+
+	const size_t count = m_upArcs.size();
+	std::vector<SearchItem> forward(count, SearchItem{ Unreachable, -1, -1 }), backward = forward;
+	IndexedHeap<double> forwardQueue, backwardQueue;
+	forwardQueue.Reset(count);
+	backwardQueue.Reset(count);
+
+	for (auto* vert : GetVisiblePoints(m_mesh, startPoint))
+	{
+		forward[vert->GetIndex()].length = Vec2(*vert - startPoint).GetLength();
+		forwardQueue.Push(vert->GetIndex(), forward[vert->GetIndex()].length);
+	}
+
+	for (auto* vert : GetVisiblePoints(m_mesh, endPoint))
+	{
+		backward[vert->GetIndex()].length = Vec2(*vert - endPoint).GetLength();
+		backwardQueue.Push(vert->GetIndex(), backward[vert->GetIndex()].length);
+	}
+
+	// Both searches only go up, and meet at the highest vert on the path. Stop when neither can
+	// improve on the best meeting so far.
+	double bestLength = Unreachable;
+	int meet = -1;
+	for (;;)
+	{
+		const double forwardTop = forwardQueue.IsEmpty() ? Unreachable : forwardQueue.GetTop().key;
+		const double backwardTop = backwardQueue.IsEmpty() ? Unreachable : backwardQueue.GetTop().key;
+		if (std::min(forwardTop, backwardTop) >= bestLength)
+			break;
+
+		const int vert = forwardTop <= backwardTop ? Search(forwardQueue, forward, endPoint, bestLength) : Search(backwardQueue, backward, startPoint, bestLength);
+		if (forward[vert].length != Unreachable && backward[vert].length != Unreachable && forward[vert].length + backward[vert].length < bestLength)
+		{
+			bestLength = forward[vert].length + backward[vert].length;
+			meet = vert;
+		}
+	}
+
+	if (meet < 0)
+		return false;
+
+	// Verts from start to end, unpacking shortcuts.
+	std::vector<int> verts, hop;
+	for (int vert = meet; vert >= 0; vert = forward[vert].prev)
+	{
+		verts.push_back(vert);
+		if (forward[vert].prev >= 0)
+		{
+			hop.clear();
+			Unpack(forward[vert].prev, vert, forward[vert].middle, hop);
+			verts.insert(verts.end(), hop.rbegin(), hop.rend());
+		}
+	}
+	std::reverse(verts.begin(), verts.end());
+
+	for (int vert = meet; backward[vert].prev >= 0; vert = backward[vert].prev)
+	{
+		hop.clear();
+		Unpack(backward[vert].prev, vert, backward[vert].middle, hop);
+		verts.insert(verts.end(), hop.rbegin(), hop.rend());
+		verts.push_back(backward[vert].prev);
+	}
+
+	path.push_back(endPoint);
+	for (auto it = verts.rbegin(); it != verts.rend(); ++it)
+		path.push_back(*m_mesh.GetVerts()[*it]);
+	path.push_back(startPoint);
+
+	if (length)
+		*length = bestLength;
+	return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "PathFinder.h"
+
+#include <vector>
+
+namespace Jig
+{
+	// Contraction hierarchy over the EdgeMeshVisibility graph, for long queries on large meshes that
+	// don't change. Verts are contracted least important first, adding shortcuts where no other
+	// path is as short. Queries hook up the end points as PathFinder does, then search only upwards
+	// from both ends.
+	class ContractionHierarchy
+	{
+	public:
+		ContractionHierarchy(const EdgeMesh& mesh);
+		~ContractionHierarchy();
+
+		size_t GetShortcutCount() const { return m_shortcutCount; }
+
+		// Same order as PathFinder::GetPath(): end first. Returns false if end can't be reached.
+		bool GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length = nullptr) const;
+
+	private:
+		struct Arc
+		{
+			int vert;
+			double length;
+			int middle; // Contracted vert this is a shortcut over, or -1.
+		};
+		using Arcs = std::vector<Arc>;
+
+		struct SearchItem
+		{
+			double length;
+			int prev; // -1 if from the end point.
+			int middle; // Of arc from prev.
+		};
+
+		void Contract();
+		int ProcessVert(int vert, std::vector<Arcs>& arcs, const std::vector<bool>& contracted, std::vector<double>& lengths, bool add); // Returns shortcut count.
+		static void AddArc(Arcs& arcs, int vert, double length, int middle);
+		int FindMiddle(int lower, int upper) const;
+		void Unpack(int from, int to, int middle, std::vector<int>& verts) const;
+		int Search(IndexedHeap<double>& queue, std::vector<SearchItem>& items, const Vec2& target, double bestLength) const; // Settles one vert, and returns it.
+
+		const EdgeMesh& m_mesh;
+		std::vector<Arcs> m_upArcs; // By vert index: arcs to verts contracted later.
+		size_t m_shortcutCount;
+	};
+}
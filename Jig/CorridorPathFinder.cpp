@@ -0,0 +1,165 @@
+#include "CorridorPathFinder.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Jig;
+
+CorridorPathFinder::CorridorPathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint) :
+	m_mesh(mesh), m_startPoint(startPoint), m_endPoint(endPoint), m_endFace(nullptr), m_isFinished(false), m_length(0)
+{
+	const EdgeMesh::Face* startFace = m_mesh.HitTest(m_startPoint);
+	m_endFace = m_mesh.HitTest(m_endPoint);
+
+	// Corridors only go through twins, but components also join at pinch verts. A query across one passes
+	// this, then searches everything it can reach before giving up.
+	if (!startFace || !m_endFace || startFace->GetComponent() != m_endFace->GetComponent())
+	{
+		m_isFinished = true;
+		return;
+	}
+
+	const size_t faceCount = m_mesh.GetFaces().size();
+	m_faces.assign(faceCount, FaceItem{ std::numeric_limits<double>::max(), Vec2(), nullptr });
+	m_queue.Reset(faceCount);
+
+	m_faces[startFace->GetIndex()] = FaceItem{ 0, m_startPoint, nullptr };
+	m_queue.Push(startFace->GetIndex(), Vec2(m_endPoint - m_startPoint).GetLength());
+}
+
+CorridorPathFinder::~CorridorPathFinder()
+{
+}
+
+void CorridorPathFinder::Go()
+{
+	while (!IsFinished())
+		Step();
+}
+
+void CorridorPathFinder::Step()
+{
+	KERNEL_ASSERT(!IsFinished());
+
+	if (m_queue.IsEmpty())
+	{
+		m_isFinished = true;
+		return;
+	}
+
+	const EdgeMesh::Face& face = *m_mesh.GetFaces()[m_queue.Pop().index];
+	KERNEL_ASSERT(!face.IsConcave());
+	if (&face == m_endFace)
+	{
+		Finish(face);
+		return;
+	}
+
+	const FaceItem& item = m_faces[face.GetIndex()];
+
+	for (auto& edge : face.GetEdges())
+	{
+		if (!edge.twin)
+			continue;
+
+		const Vec2 mid = (*edge.vert + *edge.next->vert) * 0.5;
+		const double length = item.length + Vec2(mid - item.entry).GetLength();
+
+		const int next = edge.twin->face->GetIndex();
+		FaceItem& nextItem = m_faces[next];
+		if (length < nextItem.length)
+		{
+			nextItem = FaceItem{ length, mid, &edge };
+			const double key = length + Vec2(m_endPoint - mid).GetLength();
+			if (m_queue.Contains(next)) // Key can go up: entry point has moved.
+				m_queue.Update(next, key);
+			else
+				m_queue.Push(next, key);
+		}
+	}
+}
+
+void CorridorPathFinder::Finish(const EdgeMesh::Face& endFace)
+{
+	std::vector<Portal> portals;
+
+	m_corridor.push_back(&endFace);
+	for (auto* edge = m_faces[endFace.GetIndex()].portal; edge; edge = m_faces[edge->face->GetIndex()].portal)
+	{
+		// Faces are CCW, so leaving through an edge its end is on the left.
+		portals.push_back(Portal{ *edge->next->vert, *edge->vert });
+		m_corridor.push_back(edge->face);
+	}
+	std::reverse(portals.begin(), portals.end());
+	std::reverse(m_corridor.begin(), m_corridor.end());
+
+	PullString(m_startPoint, m_endPoint, portals, m_path);
+
+	m_length = 0;
+	for (size_t i = 1; i < m_path.size(); ++i)
+		m_length += Vec2(m_path[i] - m_path[i - 1]).GetLength();
+
+	std::reverse(m_path.begin(), m_path.end());
+	m_isFinished = true;
+}
+
+// Simple stupid funnel algorithm: narrow the funnel portal by portal; when one side crosses the
+// other, that corner is on the path and becomes the new apex.
+void CorridorPathFinder::PullString(const Vec2& startPoint, const Vec2& endPoint, const std::vector<Portal>& portals, PathFinder::Path& path)
+{
+	std::vector<Portal> all;
+	all.reserve(portals.size() + 2);
+	all.push_back(Portal{ startPoint, startPoint });
+	all.insert(all.end(), portals.begin(), portals.end());
+	all.push_back(Portal{ endPoint, endPoint });
+
+	path.clear();
+	path.push_back(startPoint);
+
+	Vec2 apex = startPoint, left = startPoint, right = startPoint;
+	size_t leftIndex = 0, rightIndex = 0;
+
+	for (size_t i = 1; i < all.size(); ++i)
+	{
+		const Portal& portal = all[i];
+
+		// Move right side in?
+		if (Vec2(right - apex).DotSine(portal.right - apex) >= 0)
+		{
+			if (apex == right || Vec2(left - apex).DotSine(portal.right - apex) < 0)
+			{
+				right = portal.right;
+				rightIndex = i;
+			}
+			else // Crossed left side.
+			{
+				apex = right = left;
+				rightIndex = i = leftIndex;
+				path.push_back(apex);
+				continue;
+			}
+		}
+
+		// Move left side in?
+		if (Vec2(left - apex).DotSine(portal.left - apex) <= 0)
+		{
+			if (apex == left || Vec2(right - apex).DotSine(portal.left - apex) > 0)
+			{
+				left = portal.left;
+				leftIndex = i;
+			}
+			else // Crossed right side.
+			{
+				apex = left = right;
+				leftIndex = i = rightIndex;
+				path.push_back(apex);
+				continue;
+			}
+		}
+	}
+
+	if (!(path.back() == endPoint))
+		path.push_back(endPoint);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "EdgeMesh.h"
+#include "IndexedHeap.h"
+#include "PathFinder.h"
+
+#include <vector>
+
+namespace Jig
+{
+	// A* over face adjacency (twinned edges are portals), then the funnel algorithm to pull the
+	// corridor taut. Needs no EdgeMeshVisibility, and the corridor is chosen by portal midpoints
+	// so the path can be a little longer than PathFinder's. Faces must be convex: the funnel only
+	// sees portals, so it would cut through a concave face's reflex corners. Asserted as faces are searched.
+	class CorridorPathFinder
+	{
+	public:
+		struct Portal
+		{
+			Vec2 left, right; // Looking along the path.
+		};
+
+		CorridorPathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint);
+		~CorridorPathFinder();
+
+		bool IsFinished() const { return m_isFinished; }
+
+		const PathFinder::Path& GetPath() const { return m_path; } // Same order as PathFinder::GetPath(): end first.
+		double GetLength() const { return m_length; }
+
+		const std::vector<const EdgeMesh::Face*>& GetCorridor() const { return m_corridor; } // Start face first.
+
+		void Go();
+		void Step();
+
+		// Shortest path through portals, from startPoint to endPoint.
+		static void PullString(const Vec2& startPoint, const Vec2& endPoint, const std::vector<Portal>& portals, PathFinder::Path& path);
+
+	private:
+		struct FaceItem
+		{
+			double length; // Along portal midpoints to start.
+			Vec2 entry; // Portal midpoint, or start point.
+			const EdgeMesh::Edge* portal; // Edge in previous face.
+		};
+
+		void Finish(const EdgeMesh::Face& endFace);
+
+		const EdgeMesh& m_mesh;
+		const Vec2 m_startPoint, m_endPoint;
+		const EdgeMesh::Face* m_endFace;
+		bool m_isFinished;
+		PathFinder::Path m_path;
+		double m_length;
+		std::vector<const EdgeMesh::Face*> m_corridor;
+
+		std::vector<FaceItem> m_faces;
+		IndexedHeap<double> m_queue;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "Geometry.h"
 #include "Polygon.h"
+#include "Predicates.h"
 
 #include "libKernel/Debug.h"
 #include "libKernel/MinFinder.h"
@@ -224,17 +225,65 @@ void EdgeMesh::Update()
 {
 	RectGrower grower;
 
-	for (auto& face : m_faces)
+	for (size_t i = 0; i < m_faces.size(); ++i)
 	{
-		face->Update();
-		grower.Add(face->GetBBox());
+		m_faces[i]->Update();
+		m_faces[i]->m_index = (int)i;
+		grower.Add(m_faces[i]->GetBBox());
 	}
 	m_bbox = grower.GetRect();
 
+	for (size_t i = 0; i < m_verts.size(); ++i)
+		m_verts[i]->m_index = (int)i;
+
 	m_quadTree.Reset(m_bbox);
 
 	for (auto& face : m_faces)
 		m_quadTree.Insert(face.get());
+
+	UpdateComponents();
+
+	++m_version;
+}
+
+// Faces are connected across twins, and at verts they share: paths can pass through a pinch vert.
+void EdgeMesh::UpdateComponents()
+{
+	std::vector<int> parents(m_faces.size());
+	for (size_t i = 0; i < parents.size(); ++i)
+		parents[i] = (int)i;
+
+	auto find = [&](int i)
+	{
+		while (parents[i] != i)
+			i = parents[i] = parents[parents[i]];
+		return i;
+	};
+	auto join = [&](int i, int j) { parents[find(i)] = find(j); };
+
+	std::vector<int> vertFaces(m_verts.size(), -1);
+	for (auto& face : m_faces)
+		for (auto& edge : face->GetEdges())
+		{
+			if (edge.twin)
+				join(face->m_index, edge.twin->face->m_index);
+
+			int& vertFace = vertFaces[edge.vert->GetIndex()];
+			if (vertFace < 0)
+				vertFace = face->m_index;
+			else
+				join(face->m_index, vertFace);
+		}
+
+	std::vector<int> components(m_faces.size(), -1);
+	m_componentCount = 0;
+	for (auto& face : m_faces)
+	{
+		int& component = components[find(face->m_index)];
+		if (component < 0)
+			component = m_componentCount++;
+		face->m_component = component;
+	}
 }
 
 void EdgeMesh::Dump() const
@@ -558,11 +607,14 @@ double EdgeMesh::Edge::GetAngle() const
 	return prev->GetVec().Normalised().GetAngle(GetVec().Normalised());
 }
 
+bool EdgeMesh::Edge::IsConcave() const
+{
+	return Predicates::GetTurn(prev->GetVec(), GetVec()) < 0;
+}
+
 bool EdgeMesh::Edge::DoesVectorPointInside(const Jig::Vec2& vec) const
 {
-	KERNEL_ASSERT(vec.IsNormalised());
-	auto prevVec = prev->GetVec().Normalised();
-	return prevVec.GetAngle(vec) > prevVec.GetAngle(GetVec().Normalised());
+	return Predicates::CompareAngles(prev->GetVec(), vec, GetVec()) > 0;
 }
 
 bool EdgeMesh::Edge::IsRedundant() const
@@ -570,10 +622,10 @@ bool EdgeMesh::Edge::IsRedundant() const
 	if (!twin)
 		return false;
 
-	if (prev->GetVec().Normalised().GetAngle(twin->next->GetVec().Normalised()) < 0) 
+	if (Predicates::GetTurn(prev->GetVec(), twin->next->GetVec()) < 0)
 		return false;
 
-	if (twin->prev->GetVec().Normalised().GetAngle(next->GetVec().Normalised()) < 0) 
+	if (Predicates::GetTurn(twin->prev->GetVec(), next->GetVec()) < 0)
 		return false;
 
 	return true; // Both convex.
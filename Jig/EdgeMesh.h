@@ -56,6 +56,12 @@ namespace Jig
 			using Vec2::Vec2;
 			void Save(Kernel::Serial::SaveNode& node) const { __super::Save(node); node.SaveType("pos", *(Vec2*)this); node.SaveObjectID(this); }
 			void Load(const Kernel::Serial::LoadNode& node) { __super::Load(node); node.LoadType("pos", *(Vec2*)this); node.LoadObjectID(this); }
+
+			int GetIndex() const { return m_index; } // Position in GetVerts(), valid after Update().
+
+		private:
+			friend class EdgeMesh;
+			int m_index = -1;
 		};
 
 		EdgeMesh() {}
@@ -98,6 +104,8 @@ namespace Jig
 		const Edge* FindEdgeWithVert() const { return const_cast<EdgeMesh*>(this)->FindEdgeWithVert(); }
 
 		void Update();
+		unsigned GetVersion() const { return m_version; } // Changes on each Update(), for caches to check.
+		int GetComponentCount() const { return m_componentCount; }
 
 		void Dump() const;
 
@@ -248,7 +256,7 @@ namespace Jig
 
 			Vec2 GetVec() const;
 			double GetAngle() const;
-			bool IsConcave() const { return GetAngle() < 0; }
+			bool IsConcave() const;
 			bool DoesVectorPointInside(const Jig::Vec2& vec) const;
 			bool IsRedundant() const;
 			bool IsConnectedTo(const Edge& edge) const;
@@ -329,6 +337,9 @@ namespace Jig
 
 			void Dump() const;
 
+			int GetIndex() const { return m_index; } // Position in GetFaces(), valid after EdgeMesh::Update().
+			int GetComponent() const { return m_component; } // Same for faces joined by twins or verts, valid after EdgeMesh::Update().
+
 		private:
 			Edge & AddEdge(Vert* vert);
 			EdgeMesh::Face* DissolveEdge(Edge& edge, std::vector<Polygon>* newHoles);
@@ -337,15 +348,20 @@ namespace Jig
 
 			std::vector<EdgePtr> m_edges; // Unordered.
 			Rect m_bbox;
+			int m_index = -1;
+			int m_component = -1;
 		};
 
 	private:
 		bool DissolveRedundantEdges(Face& face);
+		void UpdateComponents();
 
 		std::vector<FacePtr> m_faces;
 		std::vector<VertPtr> m_verts;
 		QuadTree<Face> m_quadTree;
 		Rect m_bbox;
+		unsigned m_version = 0;
+		int m_componentCount = 0;
 	};
 void swap(EdgeMesh::Face& lhs, EdgeMesh::Face& rhs);
 }
@@ -2,6 +2,7 @@
 #include "EdgeMeshCommand.h"
 #include "Geometry.h"
 #include "Polygon.h"
+#include "Predicates.h"
 
 using namespace Jig;
 
@@ -17,9 +18,8 @@ namespace
 
 		const auto firstSeg = Line2::MakeFinite(*start.vert, polyline.empty() ? *end.vert : polyline.front());
 
-		const auto firstSegVec = firstSeg.GetVector().Normalised();
-		const auto prevVec = Vec2(*start.vert - *EdgeLoop::GetPrev(start).vert).Normalised();
-		const bool pointsInside = prevVec.GetAngle(firstSegVec) > prevVec.GetAngle(start.GetVec().Normalised());
+		const Vec2 prevVec = *start.vert - *EdgeLoop::GetPrev(start).vert;
+		const bool pointsInside = Predicates::CompareAngles(prevVec, firstSeg.GetVector(), start.GetVec()) > 0;
 
 		if (pointsInside == external)
 			return false;
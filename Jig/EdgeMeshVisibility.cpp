@@ -1,10 +1,235 @@
 #include "EdgeMeshVisibility.h"
 #include "GetVisiblePoints.h"
+#include "ThreadPool.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
 
 using namespace Jig;
 
-void EdgeMeshVisibility::Update(EdgeMesh& mesh)
+namespace
+{
+	// Where walls meet at a vert. Verts inside the mesh have none, and pinch verts, where faces
+	// only touch at the vert, have more than one.
+	struct Corner
+	{
+		Vec2 prev, next; // Wall verts.
+		const EdgeMesh::Face* face; // One of the fan of faces inside the corner.
+	};
+	using Corners = std::vector<std::vector<Corner>>; // By vert index.
+
+	Corners GetCorners(const EdgeMesh& mesh)
+	{
+		Corners corners(mesh.GetVerts().size());
+		for (auto& face : mesh.GetFaces())
+			for (auto& edge : face->GetEdges())
+				if (!edge.twin)
+					if (const EdgeMesh::Edge* nextEdge = edge.FindNextOuterEdge())
+						corners[edge.next->vert->GetIndex()].push_back(Corner{ *edge.vert, *nextEdge->next->vert, face.get() });
+		return corners;
+	}
+
+	// Shortest paths only turn at reflex corners, and at pinch verts, whatever their corners.
+	bool IsTurningPoint(const EdgeMesh::Vert& vert, const Corners& corners)
+	{
+		const auto& vertCorners = corners[vert.GetIndex()];
+		if (vertCorners.size() != 1)
+			return vertCorners.size() > 1;
+
+		// Faces are CCW, so walls turn right at reflex corners.
+		const Corner& corner = vertCorners.front();
+		return Vec2(vert - corner.prev).DotSine(corner.next - vert) < 0;
+	}
+
+	// The line doesn't cut into the corner's wall, so a shortest path can turn at vert along it.
+	bool IsTangent(const EdgeMesh::Vert& vert, const Vec2& other, const Corners& corners)
+	{
+		const auto& vertCorners = corners[vert.GetIndex()];
+		if (vertCorners.size() != 1)
+			return true;
+
+		const Corner& corner = vertCorners.front();
+		const Vec2 vec = other - vert;
+		return vec.DotSine(corner.prev - vert) * vec.DotSine(corner.next - vert) >= 0;
+	}
+
+	// A face from each fan around vert, to look out of. Verts inside the mesh have one fan.
+	std::vector<const EdgeMesh::Face*> GetFans(const EdgeMesh& mesh, const EdgeMesh::Vert& vert, const Corners& corners)
+	{
+		std::vector<const EdgeMesh::Face*> faces;
+		for (auto& corner : corners[vert.GetIndex()])
+			faces.push_back(corner.face);
+		if (faces.empty())
+			if (const EdgeMesh::Face* face = mesh.HitTest(vert))
+				faces.push_back(face);
+		return faces;
+	}
+
+	// Reduced: only links between turning points that are tangent at both ends.
+	EdgeMeshVisibility::VisibleVec GetLinks(const EdgeMesh& mesh, const EdgeMesh::Vert& vert, const Corners& corners, bool reduced)
+	{
+		if (reduced && !IsTurningPoint(vert, corners))
+			return {};
+
+		EdgeMeshVisibility::VisibleVec links;
+		Jig::GetVisiblePoints(vert, GetFans(mesh, vert, corners), links);
+
+		if (reduced)
+			links.erase(std::remove_if(links.begin(), links.end(), [&](const EdgeMesh::Vert* other)
+			{
+				return !IsTurningPoint(*other, corners) || !IsTangent(vert, *other, corners) || !IsTangent(*other, vert, corners);
+			}), links.end());
+		return links;
+	}
+}
+
+void EdgeMeshVisibility::Update(EdgeMesh& mesh, bool reduced)
+{
+	Update(mesh, ThreadPool::GetDefault(), reduced);
+}
+
+void EdgeMeshVisibility::Update(EdgeMesh& mesh, ThreadPool& threadPool, bool reduced)
+{
+	const auto& verts = mesh.GetVerts();
+	const Corners corners = GetCorners(mesh);
+
+	// Each query only reads the mesh, and writes its own vert's slot.
+	std::vector<VisibleVec> visible(verts.size());
+	const EdgeMesh& constMesh = mesh;
+	threadPool.ParallelFor(verts.size(), [&](size_t i)
+	{
+		const auto& v = verts[i];
+		visible[v->GetIndex()] = GetLinks(constMesh, *v, corners, reduced);
+	});
+
+	// Make visibility mutual. Lines grazing other verts can be found from one end only,
+	// and searches from the goal (eg. GoalField) need to walk edges backwards.
+	std::vector<VisibleVec> missing(verts.size());
+	for (auto& v : verts)
+		for (auto* other : visible[v->GetIndex()])
+		{
+			const auto& otherVisible = visible[other->GetIndex()];
+			if (!std::binary_search(otherVisible.begin(), otherVisible.end(), v.get()))
+				missing[other->GetIndex()].push_back(v.get());
+		}
+
+	for (auto& v : verts)
+	{
+		auto& vec = visible[v->GetIndex()];
+		if (!missing[v->GetIndex()].empty())
+		{
+			vec.insert(vec.end(), missing[v->GetIndex()].begin(), missing[v->GetIndex()].end());
+			std::sort(vec.begin(), vec.end());
+		}
+		v->SetData(std::make_unique<Data>(std::move(vec)));
+	}
+}
+
+void EdgeMeshVisibility::Update(EdgeMesh& mesh, const Rect& changedArea, bool reduced, std::vector<const EdgeMesh::Vert*>* changedVerts)
+{
+	Update(mesh, changedArea, ThreadPool::GetDefault(), reduced, changedVerts);
+}
+
+void EdgeMeshVisibility::Update(EdgeMesh& mesh, const Rect& changedArea, ThreadPool& threadPool, bool reduced, std::vector<const EdgeMesh::Vert*>* changedVerts)
+{
+	KERNEL_ASSERT(HasData(mesh)); // Kept verts need their lists. New verts have none yet.
+	if (changedVerts)
+		changedVerts->clear();
+
+	const auto& verts = mesh.GetVerts();
+	const Corners corners = GetCorners(mesh);
+
+	std::vector<char> recomputed(verts.size()); // Not vector<bool>: written from several threads.
+	std::vector<VisibleVec> visible(verts.size()); // Only for recomputed verts.
+	const EdgeMesh& constMesh = mesh;
+	threadPool.ParallelFor(verts.size(), [&](size_t i)
+	{
+		const auto& v = verts[i];
+		if (v->GetData() && !Jig::CanSeeArea(*v, GetFans(constMesh, *v, corners), changedArea))
+			return;
+		recomputed[v->GetIndex()] = true;
+		visible[v->GetIndex()] = GetLinks(constMesh, *v, corners, reduced);
+	});
+
+	// Kept verts can have links that only came from the other vert's side, eg. at pinch points their
+	// own query can't see past. If that vert was removed or no longer sees them, recompute them too.
+	auto isStaleLink = [&](const EdgeMesh::Vert& v, const EdgeMesh::Vert* other)
+	{
+		const size_t index = other->GetIndex(); // Stale if removed.
+		if (index >= verts.size() || verts[index].get() != other)
+			return true;
+		const auto& otherVisible = visible[index];
+		return recomputed[index] && !std::binary_search(otherVisible.begin(), otherVisible.end(), &v);
+	};
+
+	std::vector<const EdgeMesh::Vert*> stale;
+	for (auto& v : verts)
+		if (!recomputed[v->GetIndex()])
+			for (auto* other : GetData(v.get())->visible)
+				if (isStaleLink(*v, other))
+				{
+					stale.push_back(v.get());
+					break;
+				}
+
+	threadPool.ParallelFor(stale.size(), [&](size_t i)
+	{
+		visible[stale[i]->GetIndex()] = GetLinks(constMesh, *stale[i], corners, reduced);
+	});
+	for (auto* v : stale)
+		recomputed[v->GetIndex()] = true;
+
+	auto getVisible = [&](const EdgeMesh::Vert& v) -> const VisibleVec&
+	{
+		return recomputed[v.GetIndex()] ? visible[v.GetIndex()] : GetData(&v)->visible;
+	};
+
+	// Make visibility mutual, as in a full update. Links between kept verts already are.
+	std::vector<VisibleVec> missing(verts.size());
+	for (auto& v : verts)
+	{
+		const bool isRecomputed = recomputed[v->GetIndex()];
+		for (auto* other : getVisible(*v))
+		{
+			if (!isRecomputed && !recomputed[other->GetIndex()])
+				continue;
+
+			const auto& otherVisible = getVisible(*other);
+			if (!std::binary_search(otherVisible.begin(), otherVisible.end(), v.get()))
+				missing[other->GetIndex()].push_back(v.get());
+		}
+	}
+
+	for (auto& v : verts)
+	{
+		if (!recomputed[v->GetIndex()])
+		{
+			if (missing[v->GetIndex()].empty())
+				continue;
+			visible[v->GetIndex()] = GetData(v.get())->visible;
+		}
+
+		auto& vec = visible[v->GetIndex()];
+		if (!missing[v->GetIndex()].empty())
+		{
+			vec.insert(vec.end(), missing[v->GetIndex()].begin(), missing[v->GetIndex()].end());
+			std::sort(vec.begin(), vec.end());
+		}
+		v->SetData(std::make_unique<Data>(std::move(vec)));
+		if (changedVerts)
+			changedVerts->push_back(v.get());
+	}
+}
+
+void EdgeMeshVisibility::Clear(EdgeMesh& mesh)
 {
 	for (auto& v : mesh.GetVerts())
-		v->SetData(std::make_unique<Data>(Jig::GetVisiblePoints(mesh, *v)));
+		v->SetData(nullptr);
+}
+
+bool EdgeMeshVisibility::HasData(const EdgeMesh& mesh)
+{
+	const auto& verts = mesh.GetVerts();
+	return verts.empty() || std::any_of(verts.begin(), verts.end(), [](auto& v) { return v->GetData() != nullptr; });
 }
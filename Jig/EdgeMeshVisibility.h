@@ -4,6 +4,8 @@
 
 namespace Jig
 {
+	class ThreadPool;
+
 	class EdgeMeshVisibility
 	{
 	public:
@@ -12,11 +14,31 @@ namespace Jig
 		class Data : public EdgeMesh::Data
 		{
 		public:
-			Data(VisibleVec&& visible) : visible(visible) {}
+			Data(VisibleVec&& visible) : visible(std::move(visible)) {}
 			VisibleVec visible;
 		};
 
 		static const Data* GetData(const EdgeMesh::Vert* vert) { return static_cast<const Data*>(vert->GetData()); }
-		static void Update(EdgeMesh& mesh);
+		static bool HasData(const EdgeMesh& mesh); // Not cleared since the last Update(). For asserts.
+
+		// Reduced: only reflex corners (and pinch verts) get links, and only to others whose line is
+		// tangent to the walls at both ends - the only lines a shortest path between points can use.
+		// Much smaller, and quicker to build and search, but verts that aren't corners have no links,
+		// so searches from them (GoalField, Landmarks) only help at corners.
+		static void Update(EdgeMesh& mesh, bool reduced = false); // On ThreadPool::GetDefault().
+		static void Update(EdgeMesh& mesh, ThreadPool& threadPool, bool reduced = false); // Same result whatever the thread count.
+
+		// After an edit: only new verts and verts that can see into changedArea are recomputed. The others
+		// can't have gained or lost a line, so only their links to recomputed verts are patched.
+		// changedArea must cover every face added, removed or changed, before and after the edit.
+		// Removed verts must still be alive, as they are while an EdgeMeshCommand holds them for Undo().
+		// reduced must match the last full update. changedVerts, if given, is set to the verts whose lists were replaced.
+		static void Update(EdgeMesh& mesh, const Rect& changedArea, bool reduced = false, std::vector<const EdgeMesh::Vert*>* changedVerts = nullptr);
+		static void Update(EdgeMesh& mesh, const Rect& changedArea, ThreadPool& threadPool, bool reduced = false, std::vector<const EdgeMesh::Vert*>* changedVerts = nullptr);
+
+		// Frees the per-vert lists, eg. once a VisibilityGraph has them. Everything that reads them (GoalField,
+		// Landmarks, PathTable, ContractionHierarchy, ClearanceGraph, IncrementalPathFinder, and PathFinder
+		// and PathCache without a graph) asserts they're there. Needs a full Update() to bring them back.
+		static void Clear(EdgeMesh& mesh);
 	};
 }
@@ -1 +1,13 @@
 #include "Geometry.h"
+
+#include <algorithm>
+
+using namespace Jig;
+
+double Geometry::GetDistanceSquared(const Vec2& point, const Vec2& p0, const Vec2& p1)
+{
+	const Vec2 vec = p1 - p0;
+	const double lengthSquared = vec.GetLengthSquared();
+	const double t = lengthSquared > 0 ? std::clamp(Vec2(point - p0).Dot(vec) / lengthSquared, 0.0, 1.0) : 0;
+	return Vec2(point - (p0 + vec * t)).GetLengthSquared();
+}
@@ -9,6 +9,8 @@ namespace Jig
 {
 	namespace Geometry
 	{
+		double GetDistanceSquared(const Vec2& point, const Vec2& p0, const Vec2& p1); // From point to the segment p0-p1.
+
 		// http://geomalgorithms.com/a03-_inclusion.html
 		template <typename PointPairLoopT>
 		bool PointInPolygon(const PointPairLoopT& pointPairLoop, const Vec2& point)
@@ -1,90 +1,254 @@
 #include "GetVisiblePoints.h"
 #include "Geometry.h"
+#include "Predicates.h"
 
 #include "libKernel/Debug.h"
 
-#include <queue>
-#include <functional>
+#include <algorithm>
 
 using namespace Jig;
 using namespace Kernel;
 
 namespace
 {
-	void AddVisible(const Vec2& point, const Vec2& limit0, const Vec2& limit1, std::set<const EdgeMesh::Vert*>& visible, const EdgeMesh::Edge& enteringEdge)
+	// Scratch for AddVisible(), kept per thread so warm calls don't allocate.
+	struct Walk
 	{
-		for (auto& edge : enteringEdge.face->GetOtherEdges(enteringEdge))
+		struct Frame
 		{
-			const Vec2 toStart = Vec2(*edge.vert - point).Normalised();
-			if (limit1.GetAngle(toStart) > 0) // Finished.
-				break;
+			const EdgeMesh::Face* face;
+			const EdgeMesh::Edge* enteringEdge; // Null for the start face.
+			Vec2 limit0, limit1; // Anticlockwise, from point. Not used if !limited.
+			bool limited;
+		};
 
-			const Vec2 toEnd = Vec2(*edge.next->vert - point).Normalised();
-			if (limit0.GetAngle(toEnd) < 0) // Not in range yet.
-				continue;
+		std::vector<Frame> stack;
+		std::vector<unsigned> marks; // By vert index: already added if it matches epoch.
+		unsigned epoch = 0;
 
-			// Edge is at least partially visible.
+		void Begin()
+		{
+			if (++epoch == 0) // Wrapped.
+			{
+				std::fill(marks.begin(), marks.end(), 0);
+				epoch = 1;
+			}
+		}
 
-			Vec2 newLimit0;
-			if (limit0.GetAngle(toStart) >= 0) // Start is visible.
+		void Add(const EdgeMesh::Vert* vert, std::vector<const EdgeMesh::Vert*>& visible)
+		{
+			KERNEL_ASSERT(vert->GetIndex() >= 0);
+			const size_t index = vert->GetIndex();
+			if (index >= marks.size())
+				marks.resize(index + 1);
+			if (marks[index] != epoch)
 			{
-				visible.insert(edge.vert);
-				newLimit0 = toStart;
+				marks[index] = epoch;
+				visible.push_back(vert);
 			}
-			else
-				newLimit0 = limit0;
+		}
+	};
 
-			if (edge.twin)
+	Walk& GetWalk()
+	{
+		thread_local Walk walk;
+		return walk;
+	}
+
+	// Adds the verts visible from point out of face, which point is in or on.
+	void AddVisible(const EdgeMesh::Face& startFace, const Vec2& point, std::vector<const EdgeMesh::Vert*>& visible, Walk& walk)
+	{
+		walk.stack.push_back({ &startFace, nullptr, Vec2(), Vec2(), false });
+
+		while (!walk.stack.empty())
+		{
+			const Walk::Frame frame = walk.stack.back();
+			walk.stack.pop_back();
+
+			const auto& face = *frame.face;
+
+			if (!frame.limited)
+			{
+				for (auto& edge : frame.enteringEdge ? face.GetOtherEdges(*frame.enteringEdge) : face.GetEdges())
+				{
+					walk.Add(edge.vert, visible);
+
+					if (edge.twin)
+					{
+						const Vec2 limit0 = *edge.vert - point;
+						const Vec2 limit1 = *edge.next->vert - point;
+
+						if (!limit0.IsZero() && !limit1.IsZero())
+							walk.stack.push_back({ edge.twin->face, edge.twin, limit0, limit1, true });
+						else
+							walk.stack.push_back({ edge.twin->face, edge.twin, Vec2(), Vec2(), false }); // Point is on the edge - no need for limits.
+					}
+				}
+				continue;
+			}
+
+			for (auto& edge : face.GetOtherEdges(*frame.enteringEdge))
 			{
-				Vec2 newLimit1 = limit1.GetAngle(toEnd) < 0 ? toEnd : limit1;
-				AddVisible(point, newLimit0, newLimit1, visible, *edge.twin);
+				const Vec2 toStart = *edge.vert - point;
+				if (Predicates::GetSide(frame.limit1, toStart) > 0) // Finished.
+					break;
+
+				const Vec2 toEnd = *edge.next->vert - point;
+				if (Predicates::GetSide(frame.limit0, toEnd) < 0) // Not in range yet.
+					continue;
+
+				// Edge is at least partially visible.
+
+				Vec2 newLimit0;
+				if (Predicates::GetSide(frame.limit0, toStart) >= 0) // Start is visible.
+				{
+					walk.Add(edge.vert, visible);
+					newLimit0 = toStart;
+				}
+				else
+					newLimit0 = frame.limit0;
+
+				if (edge.twin)
+				{
+					Vec2 newLimit1 = Predicates::GetSide(frame.limit1, toEnd) < 0 ? toEnd : frame.limit1;
+					walk.stack.push_back({ edge.twin->face, edge.twin, newLimit0, newLimit1, true });
+				}
 			}
 		}
 	}
 
-	void AddVisible(const EdgeMesh::Face& face, const Vec2& point, std::set<const EdgeMesh::Vert*>& visible, const EdgeMesh::Edge* enteringEdge)
+	// Same walk as AddVisible(), stopping at the first face that might overlap area.
+	bool ReachesArea(const Vec2& point, const Vec2& limit0, const Vec2& limit1, const Rect& area, const EdgeMesh::Edge& enteringEdge)
 	{
-		for (auto& edge : enteringEdge ? face.GetOtherEdges(*enteringEdge) : face.GetEdges())
+		if (enteringEdge.face->GetBBox().Intersects(area))
+			return true;
+
+		for (auto& edge : enteringEdge.face->GetOtherEdges(enteringEdge))
 		{
-			visible.insert(edge.vert);
-			
+			const Vec2 toStart = *edge.vert - point;
+			if (Predicates::GetSide(limit1, toStart) > 0) // Finished.
+				break;
+
+			const Vec2 toEnd = *edge.next->vert - point;
+			if (Predicates::GetSide(limit0, toEnd) < 0) // Not in range yet.
+				continue;
+
 			if (edge.twin)
 			{
-				Vec2 limit0(*edge.vert - point);
-				Vec2 limit1(*edge.next->vert - point);
+				const Vec2 newLimit0 = Predicates::GetSide(limit0, toStart) >= 0 ? toStart : limit0;
+				const Vec2 newLimit1 = Predicates::GetSide(limit1, toEnd) < 0 ? toEnd : limit1;
+				if (ReachesArea(point, newLimit0, newLimit1, area, *edge.twin))
+					return true;
+			}
+		}
+		return false;
+	}
 
-				if (limit0.Normalise() && limit1.Normalise())
-					AddVisible(point, limit0, limit1, visible, *edge.twin);
-				else
-					AddVisible(*edge.twin->face, point, visible, edge.twin); // Point is on the edge - no need for limits. 
+	// Only edges in the cone [areaLimit0, areaLimit1] from point to area are followed.
+	bool ReachesArea(const EdgeMesh::Face& face, const Vec2& point, const Rect& area, const Vec2& areaLimit0, const Vec2& areaLimit1, const EdgeMesh::Edge* enteringEdge)
+	{
+		if (face.GetBBox().Intersects(area))
+			return true;
+
+		for (auto& edge : enteringEdge ? face.GetOtherEdges(*enteringEdge) : face.GetEdges())
+		{
+			if (!edge.twin)
+				continue;
+
+			const Vec2 limit0 = *edge.vert - point;
+			const Vec2 limit1 = *edge.next->vert - point;
+
+			if (limit0.IsZero() || limit1.IsZero()) // Point is on the edge.
+			{
+				if (ReachesArea(*edge.twin->face, point, area, areaLimit0, areaLimit1, edge.twin))
+					return true;
+				continue;
 			}
+
+			if (!Predicates::IsInSector(areaLimit0, limit0, limit1) && !Predicates::IsInSector(limit0, areaLimit0, areaLimit1)) // No overlap.
+				continue;
+
+			const Vec2 newLimit0 = Predicates::IsInSector(areaLimit0, limit0, limit1) ? areaLimit0 : limit0;
+			const Vec2 newLimit1 = Predicates::IsInSector(areaLimit1, limit0, limit1) ? areaLimit1 : limit1;
+			if (ReachesArea(point, newLimit0, newLimit1, area, *edge.twin))
+				return true;
 		}
+		return false;
 	}
 }
 
 std::vector<const EdgeMesh::Vert*> Jig::GetVisiblePoints(const EdgeMesh& mesh, const Vec2 & point)
 {
+	std::vector<const EdgeMesh::Vert*> points;
+	GetVisiblePoints(mesh, point, points);
+	return points;
+}
+
+void Jig::GetVisiblePoints(const EdgeMesh& mesh, const Vec2& point, std::vector<const EdgeMesh::Vert*>& points)
+{
+	points.clear();
+
 	const EdgeMesh::Face* startFace = mesh.HitTest(point);
 
 	if (!startFace)
-		return {};
+		return;
 
-	std::set<const EdgeMesh::Vert*> visible;
+	Walk& walk = GetWalk();
+	walk.Begin();
+	AddVisible(*startFace, point, points, walk);
 
-	AddVisible(*startFace, point, visible, nullptr);
+	std::sort(points.begin(), points.end());
+}
 
-	std::vector<const EdgeMesh::Vert*> points;
-	points.reserve(visible.size());
-	for (auto& p : visible)
-		points.push_back(p);
+void Jig::GetVisiblePoints(const EdgeMesh::Vert& vert, const std::vector<const EdgeMesh::Face*>& faces, std::vector<const EdgeMesh::Vert*>& points)
+{
+	points.clear();
 
-	return points;
+	Walk& walk = GetWalk();
+	walk.Begin(); // Verts seen out of more than one face are only added once.
+	for (auto* face : faces)
+		AddVisible(*face, vert, points, walk);
+
+	std::sort(points.begin(), points.end());
+}
+
+bool Jig::CanSeeArea(const EdgeMesh& mesh, const Vec2& point, const Rect& area)
+{
+	const EdgeMesh::Face* startFace = mesh.HitTest(point);
+	if (!startFace)
+		return area.Contains(point);
+
+	return CanSeeArea(point, { startFace }, area);
+}
+
+bool Jig::CanSeeArea(const Vec2& point, const std::vector<const EdgeMesh::Face*>& faces, const Rect& area)
+{
+	if (area.Contains(point))
+		return true;
+
+	// Point is outside area, so the corners span less than half a turn.
+	const Vec2 toCentre = area.GetCentre() - point;
+	const Vec2 corners[] = { area.m_p0, Vec2(area.m_p1.x, area.m_p0.y), area.m_p1, Vec2(area.m_p0.x, area.m_p1.y) };
+	Vec2 areaLimit0 = corners[0] - point, areaLimit1 = areaLimit0;
+	for (auto& corner : corners)
+	{
+		const Vec2 toCorner = corner - point;
+		if (Predicates::CompareAngles(toCentre, toCorner, areaLimit0) < 0)
+			areaLimit0 = toCorner;
+		if (Predicates::CompareAngles(toCentre, toCorner, areaLimit1) > 0)
+			areaLimit1 = toCorner;
+	}
+
+	for (auto* face : faces)
+		if (ReachesArea(*face, point, area, areaLimit0, areaLimit1, nullptr))
+			return true;
+	return false;
 }
 
 bool Jig::IsVisible(const EdgeMesh& mesh, const Vec2 & point0, const Vec2 & point1)
 {
-	Vec2 target = point1 - point0;
-	if (!target.Normalise())
+	const Vec2 target = point1 - point0;
+	if (target.IsZero())
 		return true;
 		
 	const EdgeMesh::Face* face = mesh.HitTest(point0);
@@ -99,12 +263,8 @@ bool Jig::IsVisible(const EdgeMesh& mesh, const Vec2 & point0, const Vec2 & poin
 		if (!edge.twin)
 			return false;
 
-		Vec2 limit0 = Vec2(edge.twin->GetVec().Normalised());
-		if (target.GetAngle(limit0) <= 0)
-		{
-			Vec2 limit1 = Vec2(-edge.twin->prev->GetVec().Normalised());
-			return target.GetAngle(limit1) > 0;
-		}
+		if (Predicates::GetTurn(target, edge.twin->GetVec()) <= 0)
+			return Predicates::GetSide(target, -edge.twin->prev->GetVec()) > 0;
 		return false;
 	};
 
@@ -119,18 +279,18 @@ bool Jig::IsVisible(const EdgeMesh& mesh, const Vec2 & point0, const Vec2 & poin
 		{
 			bool ok = false;
 
-			Vec2 limit0 = Vec2(*edge.vert - point0);
-			if (!limit0.Normalise()) // point0 at start of edge.
+			const Vec2 limit0 = *edge.vert - point0;
+			if (limit0.IsZero()) // point0 at start of edge.
 			{
 				ok = TryNeighbour(edge);
 			}
-			else if (target.GetAngle(limit0) <= 0)
+			else if (Predicates::GetTurn(target, limit0) <= 0)
 			{
-				Vec2 limit1 = Vec2(*edge.next->vert - point0);
-				if (!limit1.Normalise()) // point0 at end of edge.
+				const Vec2 limit1 = *edge.next->vert - point0;
+				if (limit1.IsZero()) // point0 at end of edge.
 					ok = TryNeighbour(edge);
 				else
-					ok = target.GetAngle(limit1) > 0;
+					ok = Predicates::GetSide(target, limit1) > 0;
 			}
 			
 			if (ok) // This edge leads to target.
@@ -6,6 +6,17 @@
 
 namespace Jig
 {
+	// Points are sorted by address. Once points and the calling thread's scratch are warm, these don't allocate.
 	std::vector<const EdgeMesh::Vert*> GetVisiblePoints(const EdgeMesh& mesh, const Vec2& point);
+	void GetVisiblePoints(const EdgeMesh& mesh, const Vec2& point, std::vector<const EdgeMesh::Vert*>& points); // Reuses points' storage.
+
+	// Looking out of each of faces, eg. one per fan of faces around vert. Faces that only touch at a
+	// pinch vert aren't joined by twins, so looking from a point only sees one fan.
+	void GetVisiblePoints(const EdgeMesh::Vert& vert, const std::vector<const EdgeMesh::Face*>& faces, std::vector<const EdgeMesh::Vert*>& points);
+
 	bool IsVisible(const EdgeMesh& mesh, const Vec2 & point0, const Vec2 & point1);
+
+	// Whether any line from point can reach area. Conservative: true if it reaches a face whose bbox overlaps area.
+	bool CanSeeArea(const EdgeMesh& mesh, const Vec2& point, const Rect& area);
+	bool CanSeeArea(const Vec2& point, const std::vector<const EdgeMesh::Face*>& faces, const Rect& area); // Looking out of each of faces.
 }
@@ -0,0 +1,94 @@
+#include "GoalField.h"
+#include "EdgeMeshVisibility.h"
+#include "GetVisiblePoints.h"
+#include "IndexedHeap.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Jig;
+
+GoalField::GoalField(const EdgeMesh& mesh, const Vec2& goal) : m_mesh(mesh), m_goal(goal)
+{
+	KERNEL_ASSERT(EdgeMeshVisibility::HasData(m_mesh));
+
+	const auto& verts = m_mesh.GetVerts();
+	m_verts.assign(verts.size(), VertItem{ std::numeric_limits<double>::max(), Unreachable });
+
+	IndexedHeap<double> queue;
+	queue.Reset(verts.size());
+
+	for (auto* vert : GetVisiblePoints(m_mesh, m_goal))
+	{
+		const double distance = Vec2(*vert - m_goal).GetLength();
+		m_verts[vert->GetIndex()] = VertItem{ distance, Goal };
+		queue.Push(vert->GetIndex(), distance);
+	}
+
+	while (!queue.IsEmpty())
+	{
+		const auto top = queue.Pop();
+		const EdgeMesh::Vert& vert = *verts[top.index];
+
+		for (auto* next : EdgeMeshVisibility::GetData(&vert)->visible)
+		{
+			const double distance = top.key + Vec2(*next - vert).GetLength();
+			VertItem& item = m_verts[next->GetIndex()];
+			if (distance < item.distance)
+			{
+				item = VertItem{ distance, top.index };
+				queue.PushOrDecrease(next->GetIndex(), distance);
+			}
+		}
+	}
+}
+
+const EdgeMesh::Vert* GoalField::GetNextHop(const EdgeMesh::Vert& vert) const
+{
+	const int next = m_verts[vert.GetIndex()].next;
+	KERNEL_ASSERT(next != Unreachable);
+	return next >= 0 ? m_mesh.GetVerts()[next].get() : nullptr;
+}
+
+bool GoalField::GetPath(const Vec2& startPoint, PathFinder::Path& path, double* length) const
+{
+	path.clear();
+
+	if (IsVisible(m_mesh, startPoint, m_goal))
+	{
+		path = { m_goal, startPoint };
+		if (length)
+			*length = Vec2(m_goal - startPoint).GetLength();
+		return true;
+	}
+
+	const EdgeMesh::Vert* best = nullptr;
+	double bestLength = std::numeric_limits<double>::max();
+
+	for (auto* vert : GetVisiblePoints(m_mesh, startPoint))
+		if (IsReachable(*vert))
+		{
+			const double total = Vec2(*vert - startPoint).GetLength() + GetDistance(*vert);
+			if (total < bestLength)
+			{
+				best = vert;
+				bestLength = total;
+			}
+		}
+
+	if (!best)
+		return false;
+
+	path.push_back(startPoint);
+	for (auto* vert = best; vert; vert = GetNextHop(*vert))
+		path.push_back(*vert);
+	path.push_back(m_goal);
+
+	std::reverse(path.begin(), path.end());
+
+	if (length)
+		*length = bestLength;
+	return true;
+}
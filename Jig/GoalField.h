@@ -0,0 +1,39 @@
+#pragma once
+
+#include "PathFinder.h"
+
+#include <vector>
+
+namespace Jig
+{
+	// Shortest distance and next hop towards a single goal for every vert, from one Dijkstra
+	// over the EdgeMeshVisibility graph. Paths from any start point then only need the start's
+	// visible verts. Rebuild if the mesh or its visibility changes.
+	class GoalField
+	{
+	public:
+		GoalField(const EdgeMesh& mesh, const Vec2& goal);
+
+		const Vec2& GetGoal() const { return m_goal; }
+
+		bool IsReachable(const EdgeMesh::Vert& vert) const { return m_verts[vert.GetIndex()].next != Unreachable; }
+		double GetDistance(const EdgeMesh::Vert& vert) const { return m_verts[vert.GetIndex()].distance; }
+		const EdgeMesh::Vert* GetNextHop(const EdgeMesh::Vert& vert) const; // Null if the goal is next.
+
+		// Same order as PathFinder::GetPath(): goal first. Returns false if goal can't be reached.
+		bool GetPath(const Vec2& startPoint, PathFinder::Path& path, double* length = nullptr) const;
+
+	private:
+		static const int Goal = -1, Unreachable = -2;
+
+		struct VertItem
+		{
+			double distance; // Along path to goal.
+			int next; // Vert index, or Goal/Unreachable.
+		};
+
+		const EdgeMesh& m_mesh;
+		const Vec2 m_goal;
+		std::vector<VertItem> m_verts;
+	};
+}
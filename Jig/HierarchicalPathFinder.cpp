@@ -0,0 +1,325 @@
+#include "HierarchicalPathFinder.h"
+#include "IndexedHeap.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace Jig;
+
+namespace
+{
+	const double Unreachable = std::numeric_limits<double>::max();
+
+	template <typename T> void HashCombine(size_t& seed, const T& val)
+	{
+		seed ^= std::hash<T>()(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	Vec2 GetMidpoint(const EdgeMesh::Edge& edge)
+	{
+		return (*edge.vert + *edge.next->vert) * 0.5;
+	}
+
+	CorridorPathFinder::Portal GetPortal(const EdgeMesh::Edge& edge) // Leaving edge's face.
+	{
+		return CorridorPathFinder::Portal{ *edge.next->vert, *edge.vert };
+	}
+}
+
+HierarchicalPathFinder::HierarchicalPathFinder(const EdgeMesh& mesh, double cellSize) : m_mesh(mesh), m_cellSize(cellSize), m_rebuiltCount(0)
+{
+	KERNEL_ASSERT(cellSize > 0);
+	Update();
+}
+
+HierarchicalPathFinder::~HierarchicalPathFinder()
+{
+}
+
+HierarchicalPathFinder::Cell HierarchicalPathFinder::GetCell(const EdgeMesh::Face& face) const
+{
+	const Vec2 centre = face.GetBBox().GetCentre();
+	return Cell((int)std::floor(centre.x / m_cellSize), (int)std::floor(centre.y / m_cellSize));
+}
+
+size_t HierarchicalPathFinder::GetSignature(const std::vector<FacePtr>& faces) const
+{
+	size_t seed = 0;
+	for (auto* face : faces)
+	{
+		HashCombine(seed, face);
+		for (auto& edge : face->GetEdges())
+		{
+			HashCombine(seed, &edge);
+			HashCombine(seed, edge.vert->x);
+			HashCombine(seed, edge.vert->y);
+
+			if (edge.twin)
+			{
+				const Cell& cell = m_faceCells[edge.twin->face->GetIndex()];
+				HashCombine(seed, cell.first);
+				HashCombine(seed, cell.second);
+			}
+		}
+	}
+	return seed;
+}
+
+void HierarchicalPathFinder::Update()
+{
+	const auto& faces = m_mesh.GetFaces();
+
+	std::map<Cell, std::vector<FacePtr>> cellFaces;
+	m_faceCells.resize(faces.size());
+	for (auto& face : faces)
+	{
+		m_faceCells[face->GetIndex()] = GetCell(*face);
+		cellFaces[m_faceCells[face->GetIndex()]].push_back(face.get());
+	}
+
+	for (auto it = m_clusters.begin(); it != m_clusters.end();)
+		it = cellFaces.count(it->first) ? std::next(it) : m_clusters.erase(it);
+
+	m_rebuiltCount = 0;
+	for (auto& item : cellFaces)
+	{
+		const size_t signature = GetSignature(item.second);
+
+		auto [it, isNew] = m_clusters.try_emplace(item.first);
+		Cluster& cluster = it->second;
+		if (isNew || cluster.signature != signature)
+		{
+			cluster.cell = item.first;
+			cluster.signature = signature;
+			cluster.faces = std::move(item.second);
+			BuildCluster(cluster);
+			++m_rebuiltCount;
+		}
+	}
+
+	m_nodes.clear();
+	m_edgeNodes.clear();
+	for (auto& item : m_clusters)
+	{
+		Cluster& cluster = item.second;
+		cluster.firstNode = (int)m_nodes.size();
+		for (auto* edge : cluster.entrances)
+		{
+			m_edgeNodes[edge] = (int)m_nodes.size();
+			m_nodes.push_back(Node{ edge, GetMidpoint(*edge), &cluster, -1 });
+		}
+	}
+
+	for (auto& node : m_nodes)
+	{
+		auto it = m_edgeNodes.find(node.edge->twin);
+		KERNEL_ASSERT(it != m_edgeNodes.end());
+		node.twin = it->second;
+	}
+}
+
+void HierarchicalPathFinder::BuildCluster(Cluster& cluster) const
+{
+	cluster.entrances.clear();
+	for (auto* face : cluster.faces)
+		for (auto& edge : face->GetEdges())
+			if (edge.twin && m_faceCells[edge.twin->face->GetIndex()] != cluster.cell)
+				cluster.entrances.push_back(&edge);
+
+	const size_t count = cluster.entrances.size();
+	cluster.distances.assign(count * count, Unreachable);
+
+	FaceMap faces;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const EdgeMesh::Edge& edge = *cluster.entrances[i];
+		SearchCell(cluster.cell, *edge.face, GetMidpoint(edge), nullptr, faces);
+
+		for (size_t j = 0; j < count; ++j)
+			cluster.distances[i * count + j] = i == j ? 0 : GetEntranceLength(faces, cluster.entrances[j]);
+	}
+}
+
+void HierarchicalPathFinder::SearchCell(const Cell& cell, const EdgeMesh::Face& startFace, const Vec2& startPoint, FacePtr targetFace, FaceMap& faces) const
+{
+	using QueueItem = std::pair<double, FacePtr>;
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+	faces.clear();
+	faces[&startFace] = FaceItem{ 0, startPoint, nullptr };
+	queue.push(QueueItem(0, &startFace));
+
+	while (!queue.empty())
+	{
+		const auto [length, face] = queue.top();
+		queue.pop();
+
+		const FaceItem item = faces[face];
+		if (length > item.length) // Already done.
+			continue;
+
+		KERNEL_ASSERT(!face->IsConcave()); // As in CorridorPathFinder, the funnel only sees portals.
+
+		if (face == targetFace)
+			return;
+
+		for (auto& edge : face->GetEdges())
+		{
+			if (!edge.twin || m_faceCells[edge.twin->face->GetIndex()] != cell)
+				continue;
+
+			const Vec2 mid = GetMidpoint(edge);
+			const double nextLength = length + Vec2(mid - item.entry).GetLength();
+
+			auto [it, isNew] = faces.try_emplace(edge.twin->face, FaceItem{ nextLength, mid, &edge });
+			if (isNew || nextLength < it->second.length)
+			{
+				it->second = FaceItem{ nextLength, mid, &edge };
+				queue.push(QueueItem(nextLength, edge.twin->face));
+			}
+		}
+	}
+}
+
+double HierarchicalPathFinder::GetEntranceLength(const FaceMap& faces, EdgePtr edge) const
+{
+	auto it = faces.find(edge->face);
+	return it == faces.end() ? Unreachable : it->second.length + Vec2(GetMidpoint(*edge) - it->second.entry).GetLength();
+}
+
+bool HierarchicalPathFinder::AddCellPortals(const Cell& cell, const EdgeMesh::Face& startFace, const Vec2& startPoint, const EdgeMesh::Face& endFace, std::vector<CorridorPathFinder::Portal>& portals) const
+{
+	FaceMap faces;
+	SearchCell(cell, startFace, startPoint, &endFace, faces);
+
+	if (!faces.count(&endFace))
+		return false;
+
+	const size_t oldSize = portals.size();
+	for (auto* edge = faces[&endFace].portal; edge; edge = faces[edge->face].portal)
+		portals.push_back(GetPortal(*edge));
+
+	std::reverse(portals.begin() + oldSize, portals.end());
+	return true;
+}
+
+bool HierarchicalPathFinder::GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length) const
+{
+	path.clear();
+
+	const EdgeMesh::Face* startFace = m_mesh.HitTest(startPoint);
+	const EdgeMesh::Face* endFace = m_mesh.HitTest(endPoint);
+
+	// As in CorridorPathFinder, only twins are travelled, so a query across a pinch vert passes this and
+	// still searches everything it can reach.
+	if (!startFace || !endFace || startFace->GetComponent() != endFace->GetComponent())
+		return false;
+
+	const Cell& startCell = m_faceCells[startFace->GetIndex()];
+	const Cell& endCell = m_faceCells[endFace->GetIndex()];
+
+	std::vector<CorridorPathFinder::Portal> portals;
+
+	if (startCell != endCell || !AddCellPortals(startCell, *startFace, startPoint, *endFace, portals))
+	{
+		// Abstract search: from start point to its cell's entrances, across the entrance graph,
+		// then into the end point from its cell's entrances.
+		const size_t nodeCount = m_nodes.size();
+		std::vector<double> nodeLengths(nodeCount, Unreachable), endLengths(nodeCount, Unreachable);
+		std::vector<int> prevNodes(nodeCount, -1);
+
+		IndexedHeap<double> queue;
+		queue.Reset(nodeCount);
+
+		FaceMap faces;
+		const Cluster& endCluster = m_clusters.at(endCell);
+		SearchCell(endCell, *endFace, endPoint, nullptr, faces);
+		for (size_t i = 0; i < endCluster.entrances.size(); ++i)
+			endLengths[endCluster.firstNode + i] = GetEntranceLength(faces, endCluster.entrances[i]);
+
+		const Cluster& startCluster = m_clusters.at(startCell);
+		SearchCell(startCell, *startFace, startPoint, nullptr, faces);
+		for (size_t i = 0; i < startCluster.entrances.size(); ++i)
+		{
+			const int node = startCluster.firstNode + (int)i;
+			nodeLengths[node] = GetEntranceLength(faces, startCluster.entrances[i]);
+			if (nodeLengths[node] != Unreachable)
+				queue.Push(node, nodeLengths[node] + Vec2(endPoint - m_nodes[node].pos).GetLength());
+		}
+
+		double bestLength = Unreachable;
+		int bestNode = -1;
+
+		auto relax = [&](int from, int to, double edgeLength)
+		{
+			const double nextLength = nodeLengths[from] + edgeLength;
+			if (nextLength < nodeLengths[to])
+			{
+				nodeLengths[to] = nextLength;
+				prevNodes[to] = from;
+				queue.PushOrDecrease(to, nextLength + Vec2(endPoint - m_nodes[to].pos).GetLength());
+			}
+		};
+
+		while (!queue.IsEmpty() && queue.GetTop().key < bestLength)
+		{
+			const int node = queue.Pop().index;
+
+			if (endLengths[node] != Unreachable && nodeLengths[node] + endLengths[node] < bestLength)
+			{
+				bestLength = nodeLengths[node] + endLengths[node];
+				bestNode = node;
+			}
+
+			relax(node, m_nodes[node].twin, 0);
+
+			const Cluster& cluster = *m_nodes[node].cluster;
+			const size_t count = cluster.entrances.size();
+			const double* distances = &cluster.distances[(node - cluster.firstNode) * count];
+			for (size_t i = 0; i < count; ++i)
+				if (distances[i] != Unreachable)
+					relax(node, cluster.firstNode + (int)i, distances[i]);
+		}
+
+		if (bestNode < 0)
+			return false;
+
+		std::vector<int> nodes;
+		for (int node = bestNode; node >= 0; node = prevNodes[node])
+			nodes.push_back(node);
+		std::reverse(nodes.begin(), nodes.end());
+
+		// Refine each hop within its cell.
+		const Node& first = m_nodes[nodes.front()];
+		KERNEL_VERIFY(AddCellPortals(startCell, *startFace, startPoint, *first.edge->face, portals));
+
+		for (size_t i = 0; i + 1 < nodes.size(); ++i)
+		{
+			const Node& node = m_nodes[nodes[i]];
+			if (node.twin == nodes[i + 1])
+				portals.push_back(GetPortal(*node.edge));
+			else
+				KERNEL_VERIFY(AddCellPortals(node.cluster->cell, *node.edge->face, node.pos, *m_nodes[nodes[i + 1]].edge->face, portals));
+		}
+
+		const Node& last = m_nodes[nodes.back()];
+		KERNEL_VERIFY(AddCellPortals(endCell, *last.edge->face, last.pos, *endFace, portals));
+	}
+
+	CorridorPathFinder::PullString(startPoint, endPoint, portals, path);
+
+	if (length)
+	{
+		*length = 0;
+		for (size_t i = 1; i < path.size(); ++i)
+			*length += Vec2(path[i] - path[i - 1]).GetLength();
+	}
+
+	std::reverse(path.begin(), path.end());
+	return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CorridorPathFinder.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace Jig
+{
+	// HPA* over faces. Faces are clustered by a grid of cells, and the portals between cells are
+	// linked by precomputed in-cell distances. Long queries search this abstract graph, then refine
+	// each hop within its cell, and pull the whole corridor taut with the funnel. Distances are
+	// measured between portal midpoints, and faces must be convex, as in CorridorPathFinder.
+	class HierarchicalPathFinder
+	{
+	public:
+		HierarchicalPathFinder(const EdgeMesh& mesh, double cellSize);
+		~HierarchicalPathFinder();
+
+		void Update(); // Call after the mesh has changed. Only rebuilds cells whose faces changed.
+
+		// Same order as PathFinder::GetPath(): end first. Returns false if end can't be reached.
+		bool GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length = nullptr) const;
+
+		size_t GetClusterCount() const { return m_clusters.size(); }
+		size_t GetEntranceCount() const { return m_nodes.size(); }
+		size_t GetRebuiltCount() const { return m_rebuiltCount; } // During last Update().
+
+	private:
+		using Cell = std::pair<int, int>;
+		using FacePtr = const EdgeMesh::Face*;
+		using EdgePtr = const EdgeMesh::Edge*;
+
+		struct Cluster
+		{
+			Cell cell;
+			size_t signature; // Hash of faces, verts and which cells they border.
+			std::vector<FacePtr> faces;
+			std::vector<EdgePtr> entrances; // Edges of faces, with twins in other cells.
+			std::vector<double> distances; // Between entrances, row major. Max if unreachable.
+			int firstNode;
+		};
+
+		struct Node // Entrance.
+		{
+			EdgePtr edge;
+			Vec2 pos; // Edge midpoint.
+			const Cluster* cluster;
+			int twin; // Same portal from the other cell.
+		};
+
+		struct FaceItem
+		{
+			double length;
+			Vec2 entry;
+			EdgePtr portal; // Edge in previous face.
+		};
+		using FaceMap = std::unordered_map<FacePtr, FaceItem>;
+
+		Cell GetCell(const EdgeMesh::Face& face) const;
+		size_t GetSignature(const std::vector<FacePtr>& faces) const;
+		void BuildCluster(Cluster& cluster) const;
+
+		// Dijkstra within a cell. Stops early when targetFace is reached.
+		void SearchCell(const Cell& cell, const EdgeMesh::Face& startFace, const Vec2& startPoint, FacePtr targetFace, FaceMap& faces) const;
+		double GetEntranceLength(const FaceMap& faces, EdgePtr edge) const;
+		bool AddCellPortals(const Cell& cell, const EdgeMesh::Face& startFace, const Vec2& startPoint, const EdgeMesh::Face& endFace, std::vector<CorridorPathFinder::Portal>& portals) const;
+
+		const EdgeMesh& m_mesh;
+		const double m_cellSize;
+
+		std::map<Cell, Cluster> m_clusters;
+		std::vector<Cell> m_faceCells; // By face index.
+		std::vector<Node> m_nodes;
+		std::unordered_map<EdgePtr, int> m_edgeNodes;
+		size_t m_rebuiltCount;
+	};
+}
@@ -0,0 +1,366 @@
+#include "IncrementalPathFinder.h"
+#include "GetVisiblePoints.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Jig;
+
+namespace
+{
+	const double Infinity = std::numeric_limits<double>::infinity();
+}
+
+IncrementalPathFinder::IncrementalPathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint) :
+	m_mesh(mesh), m_endPoint(endPoint), m_lastStartPoint(startPoint), m_keyModifier(0), m_isDirect(false), m_expandedCount(0)
+{
+	KERNEL_ASSERT(EdgeMeshVisibility::HasData(m_mesh));
+
+	m_nodes.resize(2);
+	for (auto& node : m_nodes)
+	{
+		node.g = node.rhs = Infinity;
+		node.startVisible = node.endVisible = false;
+	}
+	m_nodes[StartSlot].pos = startPoint;
+	m_nodes[EndSlot].pos = endPoint;
+	m_nodes[EndSlot].rhs = 0;
+
+	for (auto& vert : m_mesh.GetVerts())
+		AddNode(vert.get());
+
+	for (auto& node : m_nodes)
+		if (node.vert)
+			SetNeighbours(node);
+
+	m_queue.Grow(m_nodes.size());
+
+	std::vector<int> changed;
+	UpdateStartVisible();
+	UpdateEndVisible(changed);
+
+	m_queue.Push(EndSlot, CalculateKey(EndSlot));
+}
+
+IncrementalPathFinder::~IncrementalPathFinder()
+{
+}
+
+int IncrementalPathFinder::AddNode(VertPtr vert)
+{
+	int slot = (int)m_nodes.size();
+	if (m_freeSlots.empty())
+		m_nodes.emplace_back();
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+
+	Node& node = m_nodes[slot];
+	node.vert = vert;
+	node.pos = *vert;
+	node.neighbours.clear();
+	node.g = node.rhs = Infinity;
+	node.startVisible = node.endVisible = false;
+
+	m_slots[vert] = slot;
+	m_queue.Grow(m_nodes.size());
+	return slot;
+}
+
+void IncrementalPathFinder::FreeNode(int slot)
+{
+	if (m_queue.Contains(slot))
+		m_queue.Remove(slot);
+
+	Node& node = m_nodes[slot];
+	m_slots.erase(node.vert);
+	node.vert = nullptr;
+	node.neighbours.clear();
+	node.g = node.rhs = Infinity;
+	node.startVisible = node.endVisible = false;
+
+	m_freeSlots.push_back(slot);
+}
+
+void IncrementalPathFinder::SetNeighbours(Node& node)
+{
+	node.neighbours.clear();
+	for (auto* vert : EdgeMeshVisibility::GetData(node.vert)->visible)
+		if (vert != node.vert)
+			node.neighbours.push_back(m_slots.at(vert));
+}
+
+bool IncrementalPathFinder::HasNeighbours(const Node& node, const EdgeMeshVisibility::VisibleVec& visible) const
+{
+	size_t i = 0;
+	for (auto* vert : visible)
+		if (vert != node.vert)
+		{
+			if (i == node.neighbours.size() || m_nodes[node.neighbours[i]].vert != vert)
+				return false;
+			++i;
+		}
+	return i == node.neighbours.size();
+}
+
+bool IncrementalPathFinder::IsRemoved(VertPtr vert) const
+{
+	const auto& verts = m_mesh.GetVerts();
+	const size_t index = vert->GetIndex(); // Stale if removed.
+	return index >= verts.size() || verts[index].get() != vert;
+}
+
+void IncrementalPathFinder::UpdateStartVisible()
+{
+	for (int slot : m_startVisible)
+		m_nodes[slot].startVisible = false;
+
+	const Vec2& startPoint = m_nodes[StartSlot].pos;
+	GetVisiblePoints(m_mesh, startPoint, m_visibleBuffer);
+
+	m_startVisible.clear();
+	for (auto* vert : m_visibleBuffer)
+	{
+		const int slot = m_slots.at(vert);
+		m_nodes[slot].startVisible = true;
+		m_startVisible.push_back(slot);
+	}
+
+	m_isDirect = IsVisible(m_mesh, startPoint, m_endPoint);
+}
+
+void IncrementalPathFinder::UpdateEndVisible(std::vector<int>& changed)
+{
+	for (int slot : m_endVisible)
+	{
+		m_nodes[slot].endVisible = false;
+		changed.push_back(slot);
+	}
+
+	GetVisiblePoints(m_mesh, m_endPoint, m_visibleBuffer);
+
+	m_endVisible.clear();
+	for (auto* vert : m_visibleBuffer)
+	{
+		const int slot = m_slots.at(vert);
+		m_nodes[slot].endVisible = true;
+		m_endVisible.push_back(slot);
+		changed.push_back(slot);
+	}
+}
+
+void IncrementalPathFinder::SetStartPoint(const Vec2& startPoint)
+{
+	m_keyModifier += Vec2(startPoint - m_lastStartPoint).GetLength();
+	m_lastStartPoint = startPoint;
+
+	m_nodes[StartSlot].pos = startPoint;
+	UpdateStartVisible();
+	UpdateNode(StartSlot);
+}
+
+void IncrementalPathFinder::Update(const std::vector<const EdgeMesh::Vert*>& changedVerts)
+{
+	std::vector<int> changed;
+
+	// New verts first, so every vert in a changed list has a slot.
+	std::vector<int> rescan;
+	for (auto* vert : changedVerts)
+	{
+		auto it = m_slots.find(vert);
+		rescan.push_back(it == m_slots.end() ? AddNode(vert) : it->second);
+	}
+
+	// Removed verts lost their links, so they're in the old neighbours of the verts that saw them.
+	for (int slot : rescan)
+		for (int neighbour : m_nodes[slot].neighbours)
+			if (m_nodes[neighbour].vert && IsRemoved(m_nodes[neighbour].vert))
+			{
+				changed.insert(changed.end(), m_nodes[neighbour].neighbours.begin(), m_nodes[neighbour].neighbours.end());
+				FreeNode(neighbour);
+			}
+
+	// Moved, or changed visibility. Lists can be replaced without changing.
+	std::vector<int> rebuild;
+	for (int slot : rescan)
+	{
+		Node& node = m_nodes[slot];
+		if (node.pos == *node.vert && HasNeighbours(node, EdgeMeshVisibility::GetData(node.vert)->visible))
+			continue;
+
+		changed.insert(changed.end(), node.neighbours.begin(), node.neighbours.end());
+		node.pos = *node.vert;
+		rebuild.push_back(slot);
+	}
+
+	for (int slot : rebuild)
+	{
+		SetNeighbours(m_nodes[slot]);
+		changed.push_back(slot);
+		changed.insert(changed.end(), m_nodes[slot].neighbours.begin(), m_nodes[slot].neighbours.end());
+	}
+
+	UpdateStartVisible();
+	UpdateEndVisible(changed);
+	changed.push_back(StartSlot);
+
+	std::sort(changed.begin(), changed.end());
+	changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+	for (int slot : changed)
+		if (slot == StartSlot || m_nodes[slot].vert) // Might have been freed.
+			UpdateNode(slot);
+}
+
+IncrementalPathFinder::Key IncrementalPathFinder::CalculateKey(int slot) const
+{
+	const Node& node = m_nodes[slot];
+	const double g = std::min(node.g, node.rhs);
+	return Key{ g + Vec2(node.pos - m_lastStartPoint).GetLength() + m_keyModifier, g };
+}
+
+template <typename Fn>
+void IncrementalPathFinder::ForEachSuccessor(int slot, Fn fn) const
+{
+	if (slot == StartSlot)
+	{
+		for (int next : m_startVisible)
+			fn(next);
+		if (m_isDirect)
+			fn(EndSlot);
+	}
+	else if (slot != EndSlot)
+	{
+		const Node& node = m_nodes[slot];
+		for (int next : node.neighbours)
+			fn(next);
+		if (node.endVisible)
+			fn(EndSlot);
+	}
+}
+
+template <typename Fn>
+void IncrementalPathFinder::ForEachPredecessor(int slot, Fn fn) const
+{
+	if (slot == EndSlot)
+	{
+		for (int prev : m_endVisible)
+			fn(prev);
+		if (m_isDirect)
+			fn(StartSlot);
+	}
+	else if (slot != StartSlot) // Nothing goes through the start point.
+	{
+		const Node& node = m_nodes[slot];
+		for (int prev : node.neighbours)
+			fn(prev);
+		if (node.startVisible)
+			fn(StartSlot);
+	}
+}
+
+void IncrementalPathFinder::UpdateNode(int slot)
+{
+	Node& node = m_nodes[slot];
+
+	if (slot != EndSlot)
+	{
+		node.rhs = Infinity;
+		ForEachSuccessor(slot, [&](int next)
+		{
+			node.rhs = std::min(node.rhs, GetCost(slot, next) + m_nodes[next].g);
+		});
+	}
+
+	if (node.g != node.rhs)
+	{
+		if (m_queue.Contains(slot))
+			m_queue.Update(slot, CalculateKey(slot));
+		else
+			m_queue.Push(slot, CalculateKey(slot));
+	}
+	else if (m_queue.Contains(slot))
+		m_queue.Remove(slot);
+}
+
+void IncrementalPathFinder::Go()
+{
+	m_expandedCount = 0;
+
+	const Node& start = m_nodes[StartSlot];
+	while (!m_queue.IsEmpty() && (m_queue.GetTop().key < CalculateKey(StartSlot) || start.rhs != start.g))
+	{
+		++m_expandedCount;
+
+		const auto top = m_queue.GetTop();
+		const Key key = CalculateKey(top.index);
+		Node& node = m_nodes[top.index];
+
+		if (top.key < key) // Queued before the start moved.
+			m_queue.Update(top.index, key);
+		else if (node.g > node.rhs)
+		{
+			node.g = node.rhs;
+			m_queue.Remove(top.index);
+			ForEachPredecessor(top.index, [&](int prev) { UpdateNode(prev); });
+		}
+		else
+		{
+			node.g = Infinity;
+			UpdateNode(top.index);
+			ForEachPredecessor(top.index, [&](int prev) { UpdateNode(prev); });
+		}
+	}
+}
+
+bool IncrementalPathFinder::HasPath() const
+{
+	return m_nodes[StartSlot].rhs != Infinity;
+}
+
+double IncrementalPathFinder::GetLength() const
+{
+	return HasPath() ? m_nodes[StartSlot].rhs : 0;
+}
+
+PathFinder::Path IncrementalPathFinder::GetPath() const
+{
+	PathFinder::Path path;
+	if (!HasPath())
+		return path;
+
+	int slot = StartSlot;
+	path.push_back(m_lastStartPoint);
+
+	while (slot != EndSlot)
+	{
+		int best = -1;
+		double bestLength = Infinity;
+		ForEachSuccessor(slot, [&](int next)
+		{
+			const double length = GetCost(slot, next) + m_nodes[next].g;
+			if (length < bestLength)
+			{
+				best = next;
+				bestLength = length;
+			}
+		});
+
+		if (best < 0 || path.size() > m_nodes.size()) // Shouldn't happen after Go().
+		{
+			KERNEL_ASSERT(false);
+			path.clear();
+			return path;
+		}
+
+		slot = best;
+		path.push_back(m_nodes[slot].pos);
+	}
+
+	std::reverse(path.begin(), path.end());
+	return path;
+}
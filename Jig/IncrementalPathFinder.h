@@ -0,0 +1,83 @@
+#pragma once
+
+#include "EdgeMeshVisibility.h"
+#include "IndexedHeap.h"
+#include "PathFinder.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Jig
+{
+	// D* Lite over the EdgeMeshVisibility graph. Searches back from the end point, and keeps its
+	// g/rhs values between queries so that moving the start or editing the mesh only repairs the
+	// verts whose visibility changed.
+	class IncrementalPathFinder
+	{
+	public:
+		IncrementalPathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint);
+		~IncrementalPathFinder();
+
+		void SetStartPoint(const Vec2& startPoint); // Eg. agent has moved.
+		// Call after the mesh has changed, with the verts an incremental EdgeMeshVisibility::Update() replaced the
+		// lists of. Only those are rescanned. As there, removed verts must still be alive.
+		void Update(const std::vector<const EdgeMesh::Vert*>& changedVerts);
+		void Go();
+
+		bool HasPath() const;
+		PathFinder::Path GetPath() const; // Same order as PathFinder::GetPath(): end first. Call after Go().
+		double GetLength() const;
+
+		size_t GetExpandedCount() const { return m_expandedCount; } // During last Go().
+
+	private:
+		using VertPtr = const EdgeMesh::Vert*;
+
+		struct Key
+		{
+			double primary, secondary;
+			bool operator<(const Key& rhs) const { return primary < rhs.primary || (primary == rhs.primary && secondary < rhs.secondary); }
+		};
+
+		struct Node
+		{
+			VertPtr vert{}; // Null for start, end and free slots.
+			Vec2 pos; // Snapshot, to spot moved verts.
+			std::vector<int> neighbours; // Slots of the vert's visible list, when last set. Spots changed visibility.
+			double g, rhs; // Length to end point.
+			bool startVisible, endVisible;
+		};
+
+		static constexpr int StartSlot = 0, EndSlot = 1;
+
+		int AddNode(VertPtr vert);
+		void FreeNode(int slot);
+		void SetNeighbours(Node& node);
+		bool HasNeighbours(const Node& node, const EdgeMeshVisibility::VisibleVec& visible) const; // Same verts, same order.
+		bool IsRemoved(VertPtr vert) const;
+		void UpdateStartVisible();
+		void UpdateEndVisible(std::vector<int>& changed);
+
+		Key CalculateKey(int slot) const;
+		void UpdateNode(int slot);
+		double GetCost(int slot0, int slot1) const { return Vec2(m_nodes[slot0].pos - m_nodes[slot1].pos).GetLength(); }
+
+		template <typename Fn> void ForEachSuccessor(int slot, Fn fn) const; // Towards end.
+		template <typename Fn> void ForEachPredecessor(int slot, Fn fn) const; // Nodes whose rhs depends on slot.
+
+		const EdgeMesh& m_mesh;
+		const Vec2 m_endPoint;
+		Vec2 m_lastStartPoint;
+		double m_keyModifier; // km in D* Lite - heuristics have shrunk by this since the search began.
+		bool m_isDirect; // Start sees end.
+
+		std::vector<Node> m_nodes;
+		std::vector<int> m_freeSlots;
+		std::unordered_map<VertPtr, int> m_slots;
+		std::vector<int> m_startVisible, m_endVisible; // Slots.
+		std::vector<VertPtr> m_visibleBuffer;
+
+		IndexedHeap<Key> m_queue;
+		size_t m_expandedCount;
+	};
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "libKernel/Debug.h"
+
+#include <vector>
+
+namespace Jig
+{
+	// Binary min-heap of integer indices with decrease-key. Each index appears at most once.
+	template <typename KeyT>
+	class IndexedHeap
+	{
+	public:
+		struct Item
+		{
+			KeyT key;
+			int index;
+		};
+
+		// Empties the heap and allows indices in [0, indexCount).
+		void Reset(size_t indexCount)
+		{
+			for (auto& item : m_items)
+				m_positions[item.index] = -1;
+			m_items.clear();
+
+			if (m_positions.size() < indexCount)
+				m_positions.resize(indexCount, -1);
+		}
+
+		// Allows indices in [0, indexCount) without emptying the heap.
+		void Grow(size_t indexCount)
+		{
+			if (m_positions.size() < indexCount)
+				m_positions.resize(indexCount, -1);
+		}
+
+		bool IsEmpty() const { return m_items.empty(); }
+		size_t GetSize() const { return m_items.size(); }
+		bool Contains(int index) const { return m_positions[index] >= 0; }
+		const Item& GetTop() const { return m_items.front(); }
+		const std::vector<Item>& GetItems() const { return m_items; }
+
+		void Push(int index, KeyT key)
+		{
+			KERNEL_ASSERT(!Contains(index));
+			m_items.push_back(Item{ key, index });
+			SiftUp(m_items.size() - 1);
+		}
+
+		void Decrease(int index, KeyT key)
+		{
+			const size_t pos = m_positions[index];
+			KERNEL_ASSERT(!(m_items[pos].key < key));
+			m_items[pos].key = key;
+			SiftUp(pos);
+		}
+
+		// Pushes index, or lowers its key if it's already queued.
+		void PushOrDecrease(int index, KeyT key)
+		{
+			if (Contains(index))
+				Decrease(index, key);
+			else
+				Push(index, key);
+		}
+
+		// Changes key of a queued index in either direction.
+		void Update(int index, KeyT key)
+		{
+			const size_t pos = m_positions[index];
+			const bool up = key < m_items[pos].key;
+			m_items[pos].key = key;
+			if (up)
+				SiftUp(pos);
+			else
+				SiftDown(pos);
+		}
+
+		Item Pop()
+		{
+			const Item top = m_items.front();
+			m_positions[top.index] = -1;
+
+			const Item last = m_items.back();
+			m_items.pop_back();
+
+			if (!m_items.empty())
+			{
+				m_items.front() = last;
+				m_positions[last.index] = 0;
+				SiftDown(0);
+			}
+			return top;
+		}
+
+		void Remove(int index)
+		{
+			const size_t pos = m_positions[index];
+			m_positions[index] = -1;
+
+			const Item last = m_items.back();
+			m_items.pop_back();
+
+			if (pos < m_items.size())
+			{
+				m_items[pos] = last;
+				m_positions[last.index] = (int)pos;
+				if (pos > 0 && last.key < m_items[(pos - 1) / 2].key)
+					SiftUp(pos);
+				else
+					SiftDown(pos);
+			}
+		}
+
+	private:
+		void SiftUp(size_t pos)
+		{
+			const Item item = m_items[pos];
+			while (pos > 0)
+			{
+				const size_t parent = (pos - 1) / 2;
+				if (!(item.key < m_items[parent].key))
+					break;
+
+				m_items[pos] = m_items[parent];
+				m_positions[m_items[pos].index] = (int)pos;
+				pos = parent;
+			}
+			m_items[pos] = item;
+			m_positions[item.index] = (int)pos;
+		}
+
+		void SiftDown(size_t pos)
+		{
+			const Item item = m_items[pos];
+			const size_t size = m_items.size();
+			while (true)
+			{
+				size_t child = pos * 2 + 1;
+				if (child >= size)
+					break;
+
+				if (child + 1 < size && m_items[child + 1].key < m_items[child].key)
+					++child;
+
+				if (!(m_items[child].key < item.key))
+					break;
+
+				m_items[pos] = m_items[child];
+				m_positions[m_items[pos].index] = (int)pos;
+				pos = child;
+			}
+			m_items[pos] = item;
+			m_positions[item.index] = (int)pos;
+		}
+
+		std::vector<Item> m_items;
+		std::vector<int> m_positions; // Index -> position in m_items, or -1.
+	};
+}
@@ -0,0 +1,142 @@
+#include "Landmarks.h"
+#include "EdgeMeshVisibility.h"
+#include "IndexedHeap.h"
+#include "ThreadPool.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+using namespace Jig;
+
+namespace
+{
+	const float Unreachable = FLT_MAX;
+}
+
+Landmarks::Landmarks(const EdgeMesh& mesh, size_t count) : m_mesh(mesh)
+{
+	SelectVerts(count);
+	Init(ThreadPool::GetDefault());
+}
+
+Landmarks::Landmarks(const EdgeMesh& mesh, size_t count, ThreadPool& threadPool) : m_mesh(mesh)
+{
+	SelectVerts(count);
+	Init(threadPool);
+}
+
+// Farthest point selection, by straight line length. Cheap, and spreads them around the edges.
+void Landmarks::SelectVerts(size_t count)
+{
+	const auto& verts = m_mesh.GetVerts();
+	count = std::min(count, verts.size());
+	if (count == 0)
+		return;
+
+	std::vector<double> nearest(verts.size(), std::numeric_limits<double>::max());
+
+	const EdgeMesh::Vert* next = verts.front().get();
+	for (auto& vert : verts) // Start from an extreme, not an arbitrary vert.
+		if (Vec2(*vert - *verts.front()).GetLengthSquared() > Vec2(*next - *verts.front()).GetLengthSquared())
+			next = vert.get();
+
+	while (m_verts.size() < count)
+	{
+		m_verts.push_back(next);
+
+		double farthest = -1;
+		for (auto& vert : verts)
+		{
+			double& length = nearest[vert->GetIndex()];
+			length = std::min(length, Vec2(*vert - *m_verts.back()).GetLengthSquared());
+			if (length > farthest)
+			{
+				farthest = length;
+				next = vert.get();
+			}
+		}
+	}
+}
+
+void Landmarks::Init(ThreadPool& threadPool)
+{
+	KERNEL_ASSERT(EdgeMeshVisibility::HasData(m_mesh));
+
+	const auto& verts = m_mesh.GetVerts();
+	const size_t count = m_verts.size();
+	m_lengths.assign(verts.size() * count, Unreachable);
+
+	threadPool.ParallelFor(count, [&](size_t landmark)
+	{
+		std::vector<double> lengths(verts.size(), std::numeric_limits<double>::max());
+		IndexedHeap<double> queue;
+		queue.Reset(verts.size());
+
+		lengths[m_verts[landmark]->GetIndex()] = 0;
+		queue.Push(m_verts[landmark]->GetIndex(), 0);
+
+		while (!queue.IsEmpty())
+		{
+			const auto top = queue.Pop();
+			const EdgeMesh::Vert& vert = *verts[top.index];
+
+			for (auto* next : EdgeMeshVisibility::GetData(&vert)->visible)
+			{
+				const double length = top.key + Vec2(*next - vert).GetLength();
+				if (length < lengths[next->GetIndex()])
+				{
+					lengths[next->GetIndex()] = length;
+					queue.PushOrDecrease(next->GetIndex(), length);
+				}
+			}
+		}
+
+		for (size_t i = 0; i < verts.size(); ++i)
+			if (lengths[i] != std::numeric_limits<double>::max())
+			{
+				float length = (float)lengths[i];
+				if (length > lengths[i])
+					length = std::nextafter(length, 0.0f);
+				m_lengths[i * count + landmark] = length;
+			}
+	});
+}
+
+void Landmarks::GetEndLengths(const Vec2& endPoint, const std::vector<const EdgeMesh::Vert*>& endVisible, std::vector<double>& endLengths) const
+{
+	const size_t count = m_verts.size();
+	endLengths.assign(count, std::numeric_limits<double>::max());
+
+	for (auto* vert : endVisible)
+	{
+		const double edgeLength = Vec2(endPoint - *vert).GetLength();
+		const float* lengths = &m_lengths[vert->GetIndex() * count];
+		for (size_t i = 0; i < count; ++i)
+			if (lengths[i] != Unreachable)
+				endLengths[i] = std::min(endLengths[i], lengths[i] + edgeLength);
+	}
+}
+
+double Landmarks::GetLowerBound(const EdgeMesh::Vert& vert, const std::vector<double>& endLengths) const
+{
+	const size_t count = m_verts.size();
+	const float* lengths = &m_lengths[vert.GetIndex() * count];
+
+	double bound = 0;
+	for (size_t i = 0; i < count; ++i)
+		if (lengths[i] != Unreachable && endLengths[i] != std::numeric_limits<double>::max())
+		{
+			// Only d(L, end) - d(L, v), for simplicity. d(L, v) - d(L, end) is a bound too, but with several
+			// end points it would need the farthest end's length, not the nearest's. Stored lengths are
+			// rounded down by up to an ulp, which could push the difference up.
+			const double length = lengths[i];
+			const double diff = endLengths[i] - length - (endLengths[i] + length) * FLT_EPSILON;
+			bound = std::max(bound, diff);
+		}
+
+	return bound;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "EdgeMesh.h"
+
+#include <vector>
+
+namespace Jig
+{
+	class ThreadPool;
+
+	// Shortest lengths from a few spread out verts over the EdgeMeshVisibility graph, for the ALT
+	// (A*, landmarks, triangle inequality) heuristic: d(L, end) - d(L, v) <= d(v, end).
+	// Rebuild if the mesh or its visibility changes.
+	class Landmarks
+	{
+	public:
+		Landmarks(const EdgeMesh& mesh, size_t count);
+		Landmarks(const EdgeMesh& mesh, size_t count, ThreadPool& threadPool);
+
+		size_t GetCount() const { return m_verts.size(); }
+		const EdgeMesh::Vert& GetVert(size_t landmark) const { return *m_verts[landmark]; }
+
+		// Lengths from each landmark to endPoint, through endVisible.
+		void GetEndLengths(const Vec2& endPoint, const std::vector<const EdgeMesh::Vert*>& endVisible, std::vector<double>& endLengths) const;
+
+		// Lower bound on the length from vert to the end point that endLengths came from.
+		double GetLowerBound(const EdgeMesh::Vert& vert, const std::vector<double>& endLengths) const;
+
+	private:
+		void Init(ThreadPool& threadPool);
+		void SelectVerts(size_t count);
+
+		const EdgeMesh& m_mesh;
+		std::vector<const EdgeMesh::Vert*> m_verts;
+		std::vector<float> m_lengths; // By vert index, then landmark. Rounded down; max if unreachable.
+	};
+}
@@ -4,15 +4,17 @@
 
 using namespace Jig;
 
-Line2::Line2() : m_c(0), m_m(0), m_vert(false), m_valid(false), m_finite(false)
+Line2::Line2() : m_c(0), m_m(0), m_vert(false), m_finite(false)
 {
+	Update();
 }
 
-Line2::Line2(const Vec2& p0, const Vec2& p1, bool finite) : m_p0(p0), m_p1(p1), m_finite(finite), m_c(0), m_m(0), m_vert(false), m_valid(false)
+Line2::Line2(const Vec2& p0, const Vec2& p1, bool finite) : m_p0(p0), m_p1(p1), m_finite(finite), m_c(0), m_m(0), m_vert(false)
 {
+	Update();
 }
 
-Line2::Line2(const Vec2& p0, double m) : m_p0(p0), m_m(m), m_vert(false), m_valid(true), m_finite(false)
+Line2::Line2(const Vec2& p0, double m) : m_p0(p0), m_m(m), m_vert(false), m_finite(false)
 {
 	m_c = p0.y - m * p0.x;
 	m_p1.x = 0; 
@@ -42,19 +44,19 @@ Line2 Line2::MakeHorizontal(double y)
 void Line2::SwapPoints()
 {
 	std::swap(m_p0, m_p1);
-	m_valid = false;
+	Update();
 }
 
 void Line2::SetP0(const Vec2& p0)
 {
 	m_p0 = p0; 
-	m_valid = false;
+	Update();
 }
 	
 void Line2::SetP1(const Vec2& p1)
 {
 	m_p1 = p1; 
-	m_valid = false;
+	Update();
 }
 		
 const Vec2& Line2::GetP0() const
@@ -81,9 +83,6 @@ double Line2::Length() const
 
 bool Line2::Intersect(const Line2& that, Vec2* pPoint) const
 {
-	Validate();
-	that.Validate();
-
 	if (that.IsVertical())
 		return IsVertical() ? false : that.Intersect(*this, pPoint);
 
@@ -124,8 +123,6 @@ Line2 Line2::GetPerpBisector() const
 	if (!m_finite)
 		throw;
 
-	Validate();
-
 	Vec2 centre = m_p0 + (m_p1 - m_p0) / 2.0;
 	if (IsVertical())
 		return Line2(centre, 0);
@@ -137,8 +134,6 @@ Line2 Line2::GetPerpBisector() const
 
 Line2 Line2::GetPerpThroughtPoint(const Vec2& point) const
 {
-	Validate();
-
 	if (IsVertical())
 		return MakeHorizontal(point.y);
 	if (IsHorizontal())
@@ -149,8 +144,6 @@ Line2 Line2::GetPerpThroughtPoint(const Vec2& point) const
 
 bool Line2::PerpIntersect(const Vec2& point, double* dist, Vec2* intersection) const
 {
-	Validate();
-
 	Line2 perp = GetPerpThroughtPoint(point);
 
 	Vec2 ip;
@@ -179,21 +172,17 @@ Rect Line2::GetBBox() const
 
 bool Line2::IsHorizontal() const
 {
-	Validate();
 	return !IsVertical() && fabs(m_m) < Epsilon;
 }
 
 double Line2::GetGradient() const
 {
-	Validate();
 	return m_m;
 }
 
 // Assumes point is on extrapolated line. 
 bool Line2::IsPointWithinFiniteRange(const Vec2& point) const
 {
-	Validate();
-
 	if (!m_finite)
 		throw;
 
@@ -206,15 +195,11 @@ bool Line2::IsPointWithinFiniteRange(const Vec2& point) const
 	return r.m_p0.y <= point.y && point.y <= r.m_p1.y;
 }
 
-void Line2::Validate() const
+void Line2::Update()
 {
-	if (m_valid)
-		return;
-
 	double diffX = m_p1.x - m_p0.x;
 	m_vert = fabs(diffX) < Epsilon;
 
 	m_m = m_vert ? 0 : (m_p1.y - m_p0.y) / diffX;
 	m_c = m_vert ? 0 : m_p0.y - (m_m*m_p0.x);
-	m_valid = true;
 }
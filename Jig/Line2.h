@@ -36,20 +36,20 @@ public:
 	Vec2 GetVector() const { return m_p1 - m_p0; }
 	Rect GetBBox() const;
 
-	bool IsVertical() const { Validate();  return m_vert; }
+	bool IsVertical() const { return m_vert; }
 	bool IsHorizontal() const;
 	double GetGradient() const;
 
 private:
 	Line2(const Vec2& p0, const Vec2& p1, bool finite);
 	Line2(const Vec2& p0, double m);
-	void Validate() const;
+	void Update(); // Slope and intercept, kept current so const methods don't write - safe to share between threads.
 	bool IsPointWithinFiniteRange(const Vec2& point) const;
 
 	Vec2 m_p0, m_p1;
 	bool m_finite;
-	mutable double m_m, m_c;
-	mutable bool m_vert, m_valid;
+	double m_m, m_c;
+	bool m_vert;
 };
 
 }
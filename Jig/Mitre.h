@@ -9,7 +9,7 @@ namespace Jig
 	enum class LineAlignment { Inner, Centre, Outer };
 
 	template <typename T>
-	std::optional<Vec2T<T>> GetMitreVec(const Vec2T<T>& point, const Vec2T<T>* prev, const Vec2T<T>* next, float thickness)
+	std::optional<Vec2T<T>> GetMitreVec(const Vec2T<T>& point, const Vec2T<T>* prev, const Vec2T<T>* next, typename Vec2T<T>::Type thickness)
 	{
 		Vec2T<T> v1, v2;
 		bool valid1{}, valid2{};
@@ -48,14 +48,14 @@ namespace Jig
 				if (n.Normalise())
 				{
 					normal = n;
-					thickness /= (float)n1.Dot(normal);
+					thickness /= n1.Dot(normal);
 				}
 			}
 		}
 		else
 			return {};
 
-		return { normal * Vec2T<T>::Type(thickness) };
+		return { normal * thickness };
 	}
 
 	template <typename T>
@@ -0,0 +1,116 @@
+#include "Obstacles.h"
+#include "Geometry.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+
+using namespace Jig;
+
+Obstacles::Obstacles(const EdgeMesh& mesh) : m_mesh(mesh), m_activeCircleCount(0)
+{
+}
+
+Obstacles::~Obstacles()
+{
+}
+
+uint64_t Obstacles::MakeKey(const EdgeMesh::Vert& vert0, const EdgeMesh::Vert& vert1)
+{
+	const uint32_t index0 = (uint32_t)vert0.GetIndex(), index1 = (uint32_t)vert1.GetIndex();
+	return (uint64_t)std::min(index0, index1) << 32 | std::max(index0, index1);
+}
+
+void Obstacles::BlockVert(const EdgeMesh::Vert& vert, bool blocked)
+{
+	if (m_blockedVerts.size() != m_mesh.GetVerts().size())
+		m_blockedVerts.resize(m_mesh.GetVerts().size());
+
+	m_blockedVerts[vert.GetIndex()] = blocked;
+}
+
+void Obstacles::BlockLink(const EdgeMesh::Vert& vert0, const EdgeMesh::Vert& vert1, bool blocked)
+{
+	if (blocked)
+		m_blockedLinks.insert(MakeKey(vert0, vert1));
+	else
+		m_blockedLinks.erase(MakeKey(vert0, vert1));
+}
+
+int Obstacles::AddCircle(const Vec2& centre, double radius)
+{
+	KERNEL_ASSERT(radius > 0);
+
+	int id;
+	if (m_freeCircles.empty())
+	{
+		id = (int)m_circles.size();
+		m_circles.emplace_back();
+	}
+	else
+	{
+		id = m_freeCircles.back();
+		m_freeCircles.pop_back();
+	}
+
+	m_circles[id] = Circle{ centre, radius, true };
+	++m_activeCircleCount;
+	return id;
+}
+
+void Obstacles::MoveCircle(int id, const Vec2& centre)
+{
+	KERNEL_ASSERT(m_circles[id].active);
+	m_circles[id].centre = centre;
+}
+
+void Obstacles::RemoveCircle(int id)
+{
+	KERNEL_ASSERT(m_circles[id].active);
+	m_circles[id].active = false;
+	m_freeCircles.push_back(id);
+	--m_activeCircleCount;
+}
+
+void Obstacles::Clear()
+{
+	m_blockedVerts.clear();
+	m_blockedLinks.clear();
+	m_circles.clear();
+	m_freeCircles.clear();
+	m_activeCircleCount = 0;
+}
+
+bool Obstacles::IsBlocked(const EdgeMesh::Vert& vert) const
+{
+	const size_t index = vert.GetIndex();
+	return index < m_blockedVerts.size() && m_blockedVerts[index];
+}
+
+bool Obstacles::IsBlocked(const Vec2& point0, const Vec2& point1) const
+{
+	if (m_activeCircleCount == 0)
+		return false;
+
+	for (auto& circle : m_circles)
+		if (circle.active && Geometry::GetDistanceSquared(circle.centre, point0, point1) < circle.radius * circle.radius)
+			return true;
+
+	return false;
+}
+
+bool Obstacles::IsBlocked(const EdgeMesh::Vert& vert0, const EdgeMesh::Vert& vert1) const
+{
+	if (IsBlocked(vert0) || IsBlocked(vert1))
+		return true;
+
+	if (!m_blockedLinks.empty() && m_blockedLinks.count(MakeKey(vert0, vert1)))
+		return true;
+
+	return IsBlocked(Vec2(vert0), Vec2(vert1));
+}
+
+bool Obstacles::IsBlocked(const Vec2& point, const EdgeMesh::Vert& vert) const
+{
+	return IsBlocked(vert) || IsBlocked(point, Vec2(vert));
+}
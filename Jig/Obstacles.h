@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EdgeMesh.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace Jig
+{
+	// Temporary blockers - doors, vehicles, other agents - that PathFinder avoids without changing
+	// the mesh or its visibility. Blocking and unblocking is O(1); circles are checked against each
+	// link as it's expanded, so keep their number small. Vert indices are only valid until the
+	// mesh changes: call Clear() then.
+	class Obstacles
+	{
+	public:
+		Obstacles(const EdgeMesh& mesh);
+		~Obstacles();
+
+		void BlockVert(const EdgeMesh::Vert& vert, bool blocked = true);
+		void BlockLink(const EdgeMesh::Vert& vert0, const EdgeMesh::Vert& vert1, bool blocked = true); // Visibility link, either direction.
+
+		int AddCircle(const Vec2& centre, double radius); // Returns id for MoveCircle() and RemoveCircle().
+		void MoveCircle(int id, const Vec2& centre);
+		void RemoveCircle(int id);
+
+		void Clear();
+
+		bool IsBlocked(const EdgeMesh::Vert& vert) const;
+		bool IsBlocked(const Vec2& point0, const Vec2& point1) const; // By a circle.
+		bool IsBlocked(const EdgeMesh::Vert& vert0, const EdgeMesh::Vert& vert1) const; // Either vert, the link or a circle.
+		bool IsBlocked(const Vec2& point, const EdgeMesh::Vert& vert) const; // The vert or a circle.
+
+	private:
+		struct Circle
+		{
+			Vec2 centre;
+			double radius;
+			bool active;
+		};
+
+		static uint64_t MakeKey(const EdgeMesh::Vert& vert0, const EdgeMesh::Vert& vert1);
+
+		const EdgeMesh& m_mesh;
+		std::vector<bool> m_blockedVerts; // By vert index.
+		std::unordered_set<uint64_t> m_blockedLinks;
+		std::vector<Circle> m_circles;
+		std::vector<int> m_freeCircles;
+		size_t m_activeCircleCount;
+	};
+}
@@ -0,0 +1,133 @@
+#include "PathCache.h"
+#include "EdgeMeshVisibility.h"
+#include "GetVisiblePoints.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+
+using namespace Jig;
+
+PathCache::PathCache(const EdgeMesh& mesh, size_t capacity, double tolerance) : PathCache(mesh, capacity, tolerance, PathFinder::Options())
+{
+}
+
+PathCache::PathCache(const EdgeMesh& mesh, size_t capacity, double tolerance, const PathFinder::Options& options) :
+	m_mesh(mesh), m_capacity(capacity), m_tolerance(tolerance), m_options(options), m_version(mesh.GetVersion()), m_hitCount(0), m_missCount(0)
+{
+	KERNEL_ASSERT(capacity > 0 && !options.anytime && !options.obstacles); // Cached paths wouldn't see obstacles change.
+	KERNEL_ASSERT(options.graph || EdgeMeshVisibility::HasData(mesh));
+}
+
+PathCache::~PathCache()
+{
+}
+
+void PathCache::Clear()
+{
+	m_entries.clear();
+	m_index.clear();
+}
+
+uint64_t PathCache::MakeKey(const EdgeMesh::Face& startFace, const EdgeMesh::Face& endFace)
+{
+	return (uint64_t)(uint32_t)startFace.GetIndex() << 32 | (uint32_t)endFace.GetIndex();
+}
+
+// IsVisible() can miss verts shared by several faces, so fall back to the full visible set.
+bool PathCache::CanSee(const Vec2& point, const EdgeMesh::Vert& vert)
+{
+	if (IsVisible(m_mesh, point, vert))
+		return true;
+
+	GetVisiblePoints(m_mesh, point, m_visible);
+	return std::find(m_visible.begin(), m_visible.end(), &vert) != m_visible.end();
+}
+
+bool PathCache::TryEntry(const Entry& entry, const Vec2& startPoint, const Vec2& endPoint, PathFinder::Result& result)
+{
+	if (Vec2(startPoint - entry.startPoint).GetLengthSquared() > m_tolerance * m_tolerance ||
+		Vec2(endPoint - entry.endPoint).GetLengthSquared() > m_tolerance * m_tolerance)
+		return false;
+
+	result.path.clear();
+	result.length = 0;
+
+	if (!entry.found) // Same faces, so still unreachable.
+		return true;
+
+	if (entry.verts.empty())
+	{
+		if (!IsVisible(m_mesh, startPoint, endPoint))
+			return false;
+	}
+	else if (!CanSee(endPoint, *entry.verts.front()) || !CanSee(startPoint, *entry.verts.back()))
+		return false;
+
+	result.path.push_back(endPoint);
+	for (auto* vert : entry.verts)
+		result.path.push_back(*vert);
+	result.path.push_back(startPoint);
+
+	for (size_t i = 1; i < result.path.size(); ++i)
+		result.length += Vec2(result.path[i] - result.path[i - 1]).GetLength();
+
+	return true;
+}
+
+void PathCache::GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Result& result)
+{
+	if (m_mesh.GetVersion() != m_version)
+	{
+		Clear();
+		m_version = m_mesh.GetVersion();
+	}
+
+	const EdgeMesh::Face* startFace = m_mesh.HitTest(startPoint);
+	const EdgeMesh::Face* endFace = m_mesh.HitTest(endPoint);
+	if (!startFace || !endFace)
+	{
+		result.path.clear();
+		result.length = 0;
+		return;
+	}
+
+	const uint64_t key = MakeKey(*startFace, *endFace);
+	auto it = m_index.find(key);
+	if (it != m_index.end())
+	{
+		if (TryEntry(*it->second, startPoint, endPoint, result))
+		{
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			++m_hitCount;
+			return;
+		}
+	}
+	++m_missCount;
+
+	PathFinder pathFinder(m_mesh, startPoint, endPoint, m_options, m_context);
+	pathFinder.Go();
+	result.path = pathFinder.GetPath();
+	result.length = pathFinder.GetLength();
+
+	// One entry per face pair: replace the old one, or make room for a new one.
+	if (it == m_index.end())
+	{
+		if (m_entries.size() == m_capacity)
+		{
+			m_index.erase(m_entries.back().key);
+			m_entries.pop_back();
+		}
+		m_entries.emplace_front();
+		it = m_index.emplace(key, m_entries.begin()).first;
+	}
+	else
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+	Entry& entry = m_entries.front();
+	entry.key = key;
+	entry.startPoint = startPoint;
+	entry.endPoint = endPoint;
+	entry.found = !result.path.empty();
+	pathFinder.GetPathVerts(entry.verts);
+}
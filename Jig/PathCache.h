@@ -0,0 +1,56 @@
+#pragma once
+
+#include "PathFinder.h"
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace Jig
+{
+	// LRU cache of PathFinder results, keyed by start and end face. A query hits if its end points
+	// are within tolerance of the cached ones and can still see the cached corridor; the path is then
+	// the cached verts with the new end points, so may be slightly longer than optimal.
+	// Everything is dropped when the mesh's version changes. Visibility must be current.
+	class PathCache
+	{
+	public:
+		PathCache(const EdgeMesh& mesh, size_t capacity, double tolerance);
+		PathCache(const EdgeMesh& mesh, size_t capacity, double tolerance, const PathFinder::Options& options);
+		~PathCache();
+
+		void GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Result& result);
+
+		void Clear();
+
+		size_t GetSize() const { return m_entries.size(); }
+		size_t GetHitCount() const { return m_hitCount; }
+		size_t GetMissCount() const { return m_missCount; }
+
+	private:
+		struct Entry
+		{
+			uint64_t key;
+			Vec2 startPoint, endPoint;
+			std::vector<const EdgeMesh::Vert*> verts; // Between end and start, end first. Empty if direct.
+			bool found;
+		};
+		using EntryList = std::list<Entry>; // Most recently used first.
+
+		static uint64_t MakeKey(const EdgeMesh::Face& startFace, const EdgeMesh::Face& endFace);
+		bool TryEntry(const Entry& entry, const Vec2& startPoint, const Vec2& endPoint, PathFinder::Result& result);
+		bool CanSee(const Vec2& point, const EdgeMesh::Vert& vert);
+
+		const EdgeMesh& m_mesh;
+		const size_t m_capacity;
+		const double m_tolerance;
+		const PathFinder::Options m_options;
+
+		EntryList m_entries;
+		std::unordered_map<uint64_t, EntryList::iterator> m_index;
+		unsigned m_version;
+		PathFinder::Context m_context;
+		std::vector<const EdgeMesh::Vert*> m_visible;
+		size_t m_hitCount, m_missCount;
+	};
+}
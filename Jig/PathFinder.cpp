@@ -2,46 +2,213 @@
 #include "EdgeMeshVisibility.h"
 #include "Geometry.h"
 #include "GetVisiblePoints.h"
+#include "Landmarks.h"
+#include "Obstacles.h"
+#include "ThreadPool.h"
+#include "VisibilityGraph.h"
 
 #include "libKernel/Debug.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace Jig;
 using namespace Kernel;
 
-PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint) : m_mesh(mesh), m_startPoint(startPoint), m_endPoint(endPoint), m_isFinished(false), m_length(0), m_currentVert(nullptr)
+void PathFinder::Context::Reset(size_t vertCount)
 {
-	if (IsVisible(m_mesh, m_startPoint, m_endPoint))
+	if (m_verts.size() < vertCount)
+		m_verts.resize(vertCount);
+
+	if (++m_generation == 0) // Wrapped - old generations might match again.
 	{
-		m_length = Vec2(m_endPoint - m_startPoint).GetLength();
-		m_path = { m_endPoint, m_startPoint };
-		m_isFinished = true;
+		for (auto& item : m_verts)
+			item.doneGeneration = item.endGeneration = item.backDoneGeneration = 0;
+		m_generation = 1;
+	}
+
+	m_queue.Reset(vertCount);
+	m_backQueue.Reset(vertCount);
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint) : PathFinder(mesh, startPoint, endPoint, Options())
+{
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint, Context& context) : PathFinder(mesh, startPoint, endPoint, Options(), context)
+{
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint, const Options& options) : PathFinder(mesh, startPoint, &endPoint, 1, options, nullptr)
+{
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint, const Options& options, Context& context) : PathFinder(mesh, startPoint, &endPoint, 1, options, &context)
+{
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const std::vector<Vec2>& endPoints, const Options& options) : PathFinder(mesh, startPoint, endPoints.data(), endPoints.size(), options, nullptr)
+{
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const std::vector<Vec2>& endPoints, const Options& options, Context& context) : PathFinder(mesh, startPoint, endPoints.data(), endPoints.size(), options, &context)
+{
+}
+
+PathFinder::PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2* endPoints, size_t endPointCount, const Options& options, Context* context) :
+	m_mesh(mesh), m_startPoint(startPoint), m_endIndex(0), m_options(options), m_isFinished(false), m_length(0), m_currentVert(nullptr), m_meetVert(nullptr), m_meetLength(std::numeric_limits<double>::max()), m_weight(options.weight), m_bound(options.weight), m_iteration(1), m_ownContext(context ? nullptr : std::make_unique<Context>()), m_context(context ? *context : *m_ownContext)
+{
+	m_context.m_endPoints.assign(endPoints, endPoints + endPointCount); // So the caller's needn't outlive this. No allocation once warm.
+	if (endPointCount)
+		m_endPoint = GetEndPoint(0);
+
+	Init();
+}
+
+PathFinder::~PathFinder()
+{
+}
+
+void PathFinder::Init()
+{
+	KERNEL_ASSERT(m_weight >= 1 && !(m_options.bidirectional && (m_weight != 1 || m_options.anytime || GetEndPointCount() != 1)));
+	KERNEL_ASSERT(!m_options.anytime || m_options.weightStep > 0); // Else the weight never drops, and Go() never returns.
+	KERNEL_ASSERT(m_options.graph ? m_options.graph->IsValid(m_mesh) : EdgeMeshVisibility::HasData(m_mesh));
+
+	m_context.Reset(m_mesh.GetVerts().size());
+	m_context.m_incons.clear();
+
+	// Faces in other components can't be reached, however far we search. Components join at pinch verts too.
+	const EdgeMesh::Face* startFace = m_mesh.HitTest(m_startPoint);
+	auto isReachable = [&](const Vec2& endPoint)
+	{
+		const EdgeMesh::Face* endFace = m_mesh.HitTest(endPoint);
+		return !startFace || !endFace || startFace->GetComponent() == endFace->GetComponent();
+	};
+
+	// A straight line is as short as it gets, unless another end point is nearer.
+	double nearestLength = std::numeric_limits<double>::max();
+	for (size_t i = 0; i < GetEndPointCount(); ++i)
+	{
+		if (!isReachable(GetEndPoint(i)))
+			continue;
+
+		const double length = Vec2(GetEndPoint(i) - m_startPoint).GetLength();
+		nearestLength = std::min(nearestLength, length);
+		if (length < m_meetLength && IsVisible(m_mesh, m_startPoint, GetEndPoint(i)) && !IsBlocked(m_startPoint, GetEndPoint(i)))
+			SetEnd(nullptr, i, length);
+	}
+
+	if (nearestLength == std::numeric_limits<double>::max() || m_meetLength <= nearestLength)
+	{
+		m_bound = 1;
+		Finish();
 		return;
 	}
 
-	std::vector<const EdgeMesh::Vert*> startVisible = GetVisiblePoints(m_mesh, m_startPoint);
-	std::vector<const EdgeMesh::Vert*> endVisible = GetVisiblePoints(m_mesh, m_endPoint);
+	auto& startVisible = m_context.m_startVisible;
+	auto& endVisible = m_context.m_endVisible;
+	GetVisiblePoints(m_mesh, m_startPoint, startVisible);
+
+	bool anyEndVisible = false;
+	auto& landmarkLengths = m_context.m_landmarkLengths;
+	if (m_options.landmarks) // Min over end points, so start from none. The context may hold another query's.
+		m_context.m_landmarkEndLengths.assign(m_options.landmarks->GetCount(), std::numeric_limits<double>::max());
 
-	if (startVisible.empty() || endVisible.empty())
+	for (size_t i = 0; i < GetEndPointCount(); ++i)
 	{
-		m_isFinished = true;
+		if (!isReachable(GetEndPoint(i)))
+			continue;
+
+		GetVisiblePoints(m_mesh, GetEndPoint(i), endVisible);
+
+		if (m_options.obstacles)
+			endVisible.erase(std::remove_if(endVisible.begin(), endVisible.end(), [&](VertPtr v) { return m_options.obstacles->IsBlocked(GetEndPoint(i), *v); }), endVisible.end());
+		anyEndVisible |= !endVisible.empty();
+
+		for (auto* v : endVisible)
+		{
+			auto& vertItem = m_context.m_verts[v->GetIndex()];
+			const double length = Vec2(GetEndPoint(i) - *v).GetLength();
+			if (vertItem.endGeneration != m_context.m_generation || length < vertItem.endLength)
+			{
+				vertItem.endGeneration = m_context.m_generation;
+				vertItem.endLength = length;
+				vertItem.endIndex = i;
+			}
+		}
+
+		if (m_options.landmarks) // Lower bound to the nearest end point.
+		{
+			m_options.landmarks->GetEndLengths(GetEndPoint(i), endVisible, landmarkLengths);
+			auto& endLengths = m_context.m_landmarkEndLengths;
+			for (size_t j = 0; j < endLengths.size(); ++j)
+				endLengths[j] = std::min(endLengths[j], landmarkLengths[j]);
+		}
+	}
+
+	if (startVisible.empty() || !anyEndVisible)
+	{
+		Finish();
 		return;
 	}
 
-	m_endVisibleSet.insert(endVisible.begin(), endVisible.end());
+	if (m_options.anytime && m_path.empty())
+		m_length = std::numeric_limits<double>::max(); // Until a path is found.
+
+	if (m_options.bidirectional)
+	{
+		if (m_options.landmarks)
+			m_options.landmarks->GetEndLengths(m_startPoint, startVisible, m_context.m_landmarkStartLengths);
+
+		for (auto* v : endVisible)
+			AddBackVert(v, nullptr, Vec2(*v - m_endPoint).GetLength());
+	}
 
 	for (auto* v : startVisible)
-		AddVert(v, nullptr, 0);
+		AddVert(v, nullptr, Vec2(*v - m_startPoint).GetLength());
 }
 
-PathFinder::~PathFinder()
+const PathFinder::DoneItem* PathFinder::FindDone(VertPtr vert) const
 {
+	const auto& item = m_context.m_verts[vert->GetIndex()];
+	return item.doneGeneration == m_context.m_generation ? &item.done : nullptr;
+}
+
+PathFinder::DoneMap PathFinder::GetDone() const
+{
+	DoneMap done;
+	for (auto& vert : m_mesh.GetVerts())
+		if (auto* item = FindDone(vert.get()))
+			done.insert(std::make_pair(vert.get(), *item));
+
+	return done;
+}
+
+void PathFinder::GetPathVerts(std::vector<VertPtr>& verts) const
+{
+	KERNEL_ASSERT(IsFinished() && !m_options.anytime);
+
+	verts.clear();
+	if (m_path.empty() || !m_meetVert)
+		return;
+
+	if (m_options.bidirectional) // Meet vert to end, exclusive.
+	{
+		for (VertPtr vert = m_context.m_verts[m_meetVert->GetIndex()].backDone.prev; vert; vert = m_context.m_verts[vert->GetIndex()].backDone.prev)
+			verts.push_back(vert);
+		std::reverse(verts.begin(), verts.end());
+	}
+
+	for (VertPtr vert = m_meetVert; vert; vert = FindDone(vert)->prev)
+		verts.push_back(vert);
 }
 
 void PathFinder::AppendPathToStart(VertPtr vert, PathFinder::Path& path) const
 {
 	path.push_back(*vert);
 
-	while (VertPtr prev = m_done.find(vert)->second.prev)
+	while (VertPtr prev = FindDone(vert)->prev)
 	{
 		path.push_back(*prev);
 		vert = prev;
@@ -50,29 +217,215 @@ void PathFinder::AppendPathToStart(VertPtr vert, PathFinder::Path& path) const
 	path.push_back(m_startPoint);
 }
 
-void PathFinder::AddVert(VertPtr vert, VertPtr prev, double prevLength)
+bool PathFinder::IsBlocked(const Vec2& point0, const Vec2& point1) const
+{
+	return m_options.obstacles && m_options.obstacles->IsBlocked(point0, point1);
+}
+
+bool PathFinder::IsBlocked(VertPtr vert, VertPtr prev, const Vec2& point) const
+{
+	if (!m_options.obstacles)
+		return false;
+	return prev ? m_options.obstacles->IsBlocked(*prev, *vert) : m_options.obstacles->IsBlocked(point, *vert);
+}
+
+void PathFinder::ExpandVert(VertPtr vert, double length)
 {
-	const double length = prevLength + Vec2(*vert - (prev ? *prev : m_startPoint)).GetLength();
+	if (const VisibilityGraph* graph = m_options.graph)
+	{
+		const auto& verts = m_mesh.GetVerts();
+		const auto links = graph->GetLinks(vert->GetIndex());
+		if (graph->HasLengths())
+		{
+			const double* linkLength = graph->GetLengths(vert->GetIndex());
+			for (uint32_t next : links)
+				AddVert(verts[next].get(), vert, length + *linkLength++);
+		}
+		else
+		{
+			for (uint32_t next : links)
+				AddVert(verts[next].get(), vert, length + Vec2(*verts[next] - *vert).GetLength());
+		}
+		return;
+	}
+
+	for (auto* next : EdgeMeshVisibility::GetData(vert)->visible)
+		AddVert(next, vert, length + Vec2(*next - *vert).GetLength());
+}
+
+void PathFinder::AddVert(VertPtr vert, VertPtr prev, double length)
+{
+	if (IsBlocked(vert, prev, m_startPoint))
+		return;
 
 	// Already added this vert? 
-	auto pair = m_done.insert(std::make_pair(vert, DoneItem{}));
-	DoneItem& item = pair.first->second;
-	if (pair.second || length < item.length) // New or shorter. 
+	auto& vertItem = m_context.m_verts[vert->GetIndex()];
+	const bool isNew = vertItem.doneGeneration != m_context.m_generation;
+	DoneItem& item = vertItem.done;
+	if (isNew || length < item.length) // New or shorter. 
 	{
 		// Initialise or update. 
+		if (isNew)
+		{
+			vertItem.doneGeneration = m_context.m_generation;
+			vertItem.closedIteration = vertItem.inconsIteration = 0;
+			if (vertItem.backDoneGeneration != m_context.m_generation)
+				InitHLengths(vert, vertItem);
+		}
 		item.length = length;
 		item.prev = prev;
 
-		// Add to queue.
-		double g = length;
-		double h = Vec2(m_endPoint - *vert).GetLength();
-		m_queue.push(QueueItem{ g, h, vert, prev }); // vert might already be in the queue, with a lower priority. 
+		if (vertItem.endGeneration == m_context.m_generation && length + vertItem.endLength < m_meetLength)
+			SetEnd(vert, vertItem.endIndex, length + vertItem.endLength);
+
+		if (m_options.anytime)
+		{
+			if (vertItem.closedIteration == m_iteration) // Don't expand twice in one iteration.
+			{
+				if (vertItem.inconsIteration != m_iteration)
+				{
+					vertItem.inconsIteration = m_iteration;
+					m_context.m_incons.push_back(vert->GetIndex());
+				}
+				return;
+			}
+		}
+
+		// Add to queue, or move up if it's already there.
+		m_context.m_queue.PushOrDecrease(vert->GetIndex(), length + m_weight * GetForwardPotential(vertItem));
+
+		if (vertItem.backDoneGeneration == m_context.m_generation && length + vertItem.backDone.length < m_meetLength)
+		{
+			m_meetLength = length + vertItem.backDone.length;
+			m_meetVert = vert;
+		}
+	}
+}
+
+void PathFinder::InitHLengths(VertPtr vert, Context::VertItem& vertItem) const
+{
+	vertItem.hLength = std::numeric_limits<double>::max();
+	for (size_t i = 0; i < GetEndPointCount(); ++i)
+		vertItem.hLength = std::min(vertItem.hLength, Vec2(GetEndPoint(i) - *vert).GetLength());
+
+	const bool isExact = GetEndPointCount() == 1 && vertItem.endGeneration == m_context.m_generation;
+	if (m_options.landmarks && !isExact)
+		vertItem.hLength = std::max(vertItem.hLength, m_options.landmarks->GetLowerBound(*vert, m_context.m_landmarkEndLengths));
+
+	if (m_options.bidirectional)
+	{
+		vertItem.backHLength = Vec2(m_startPoint - *vert).GetLength();
+		if (m_options.landmarks)
+			vertItem.backHLength = std::max(vertItem.backHLength, m_options.landmarks->GetLowerBound(*vert, m_context.m_landmarkStartLengths));
+	}
+}
+
+// Forward search key is length + this, backward is length - this. Averaging the two heuristics
+// keeps both consistent, and a path through any vert has total length forward key + backward key.
+double PathFinder::GetForwardPotential(const Context::VertItem& vertItem) const
+{
+	return m_options.bidirectional ? (vertItem.hLength - vertItem.backHLength) / 2 : vertItem.hLength;
+}
+
+// Paths end at a vert visible from an end point, or go straight there from the start if vert is null.
+void PathFinder::SetEnd(VertPtr vert, size_t endIndex, double length)
+{
+	m_meetVert = vert;
+	m_meetLength = length;
+	m_endIndex = endIndex;
+	m_endPoint = GetEndPoint(endIndex);
+
+	if (m_options.anytime) // Keep the path: verts on it might be improved before the iteration ends.
+	{
+		m_path.clear();
+		m_path.push_back(m_endPoint);
+		if (vert)
+			AppendPathToStart(vert, m_path);
+		else
+			m_path.push_back(m_startPoint);
+
+		// Verts on the way might have been shortened since their successors were added.
+		m_length = 0;
+		for (size_t i = 1; i < m_path.size(); ++i)
+			m_length += Vec2(m_path[i] - m_path[i - 1]).GetLength();
+		m_meetLength = m_length;
+	}
+}
+
+void PathFinder::Finish()
+{
+	m_isFinished = true;
+	m_path.clear();
+	m_length = 0;
+
+	if (m_meetLength == std::numeric_limits<double>::max())
+		return;
+
+	m_path.push_back(m_endPoint);
+	if (m_meetVert)
+		AppendPathToStart(m_meetVert, m_path);
+	else
+		m_path.push_back(m_startPoint);
+
+	m_length = m_meetLength;
+}
+
+void PathFinder::ExpandBackVert(VertPtr vert, double length)
+{
+	if (const VisibilityGraph* graph = m_options.graph)
+	{
+		const auto& verts = m_mesh.GetVerts();
+		const auto links = graph->GetLinks(vert->GetIndex());
+		if (graph->HasLengths())
+		{
+			const double* linkLength = graph->GetLengths(vert->GetIndex());
+			for (uint32_t next : links)
+				AddBackVert(verts[next].get(), vert, length + *linkLength++);
+		}
+		else
+		{
+			for (uint32_t next : links)
+				AddBackVert(verts[next].get(), vert, length + Vec2(*verts[next] - *vert).GetLength());
+		}
+		return;
+	}
+
+	for (auto* next : EdgeMeshVisibility::GetData(vert)->visible)
+		AddBackVert(next, vert, length + Vec2(*next - *vert).GetLength());
+}
+
+void PathFinder::AddBackVert(VertPtr vert, VertPtr prev, double length)
+{
+	if (IsBlocked(vert, prev, m_endPoint))
+		return;
+
+	auto& vertItem = m_context.m_verts[vert->GetIndex()];
+	const bool isNew = vertItem.backDoneGeneration != m_context.m_generation;
+	DoneItem& item = vertItem.backDone;
+	if (isNew || length < item.length)
+	{
+		if (isNew)
+		{
+			if (vertItem.doneGeneration != m_context.m_generation)
+				InitHLengths(vert, vertItem);
+			vertItem.backDoneGeneration = m_context.m_generation;
+		}
+		item.length = length;
+		item.prev = prev;
+
+		m_context.m_backQueue.PushOrDecrease(vert->GetIndex(), length - GetForwardPotential(vertItem));
+
+		if (vertItem.doneGeneration == m_context.m_generation && length + vertItem.done.length < m_meetLength)
+		{
+			m_meetLength = length + vertItem.done.length;
+			m_meetVert = vert;
+		}
 	}
 }
 
 PathFinder::Path PathFinder::GetPath() const 
 {
-	if (IsFinished())
+	if (IsFinished() || m_options.anytime)
 		return m_path;
 
 	PathFinder::Path path;
@@ -88,37 +441,170 @@ void PathFinder::Go()
 		Step();
 }
 
+void PathFinder::SolveBatch(const EdgeMesh& mesh, const std::vector<Request>& requests, std::vector<Result>& results)
+{
+	SolveBatch(mesh, requests, Options(), results);
+}
+
+void PathFinder::SolveBatch(const EdgeMesh& mesh, const std::vector<Request>& requests, const Options& options, std::vector<Result>& results)
+{
+	results.resize(requests.size());
+
+	ThreadPool::GetDefault().ParallelFor(requests.size(), [&](size_t i)
+	{
+		thread_local Context context;
+
+		PathFinder pathFinder(mesh, requests[i].startPoint, requests[i].endPoint, options, context);
+		pathFinder.Go();
+
+		Result& result = results[i];
+		result.path.assign(pathFinder.m_path.begin(), pathFinder.m_path.end()); // Reuse result's storage.
+		result.length = pathFinder.m_length;
+	});
+}
+
 void PathFinder::Step()
 {
 	KERNEL_ASSERT(!IsFinished());
 
-	if (m_queue.empty())
+	if (m_options.bidirectional)
 	{
-		m_path.clear();
-		m_length = 0;
-		m_isFinished = true;
+		StepBidirectional();
 		return;
 	}
 
-	const QueueItem item = m_queue.top();
-	m_queue.pop();
+	if (m_options.anytime)
+	{
+		StepAnytime();
+		return;
+	}
 
-	m_currentVert = item.vert;
-	m_length = item.gLength;
+	// Finishing is like expanding the end point: when nothing queued could lead to a shorter path.
+	auto& queue = m_context.m_queue;
+	if (queue.IsEmpty() || queue.GetTop().key >= m_meetLength)
+	{
+		Finish();
+		return;
+	}
+
+	const VertPtr vert = m_mesh.GetVerts()[queue.Pop().index].get();
+	m_currentVert = vert;
+	m_length = m_context.m_verts[vert->GetIndex()].done.length;
+
+	ExpandVert(vert, m_length);
+}
 
-	if (m_endVisibleSet.count(item.vert))
+// Expands the smaller frontier. Every path shorter than m_meetLength would still have to pass
+// through queued verts in both directions, so it can't be shorter than the sum of the top keys.
+void PathFinder::StepBidirectional()
+{
+	auto& queue = m_context.m_queue;
+	auto& backQueue = m_context.m_backQueue;
+
+	if (queue.IsEmpty() || backQueue.IsEmpty() || queue.GetTop().key + backQueue.GetTop().key >= m_meetLength)
 	{
-		KERNEL_ASSERT(m_path.empty());
-		m_path.push_back(m_endPoint);
-		AppendPathToStart(item.vert, m_path);
+		FinishBidirectional();
+		return;
+	}
 
-		m_length += Vec2(m_endPoint - *item.vert).GetLength();
+	if (queue.GetSize() <= backQueue.GetSize())
+	{
+		const VertPtr vert = m_mesh.GetVerts()[queue.Pop().index].get();
+		m_currentVert = vert;
+		m_length = m_context.m_verts[vert->GetIndex()].done.length;
 
-		m_isFinished = true;
+		ExpandVert(vert, m_length);
+	}
+	else
+	{
+		const VertPtr vert = m_mesh.GetVerts()[backQueue.Pop().index].get();
+		const double length = m_context.m_verts[vert->GetIndex()].backDone.length;
+
+		ExpandBackVert(vert, length);
+	}
+}
+
+void PathFinder::FinishBidirectional()
+{
+	m_isFinished = true;
+	m_path.clear();
+	m_length = 0;
+
+	if (!m_meetVert)
+		return;
+
+	std::vector<VertPtr> backVerts; // Meet vert to end, exclusive.
+	for (VertPtr vert = m_context.m_verts[m_meetVert->GetIndex()].backDone.prev; vert; vert = m_context.m_verts[vert->GetIndex()].backDone.prev)
+		backVerts.push_back(vert);
+
+	m_path.push_back(m_endPoint);
+	for (auto it = backVerts.rbegin(); it != backVerts.rend(); ++it)
+		m_path.push_back(**it);
+	AppendPathToStart(m_meetVert, m_path);
+
+	m_length = m_meetLength;
+}
+
+// ARA*: each iteration is a weighted A* that expands each vert at most once, and ends when
+// nothing queued could beat the best path with the current weight.
+void PathFinder::StepAnytime()
+{
+	auto& queue = m_context.m_queue;
+	if (queue.IsEmpty() || queue.GetTop().key >= m_meetLength)
+	{
+		EndIteration();
 		return;
 	}
 
-	for (auto* next : EdgeMeshVisibility::GetData(item.vert)->visible)
-		AddVert(next, item.vert, item.gLength);
+	const VertPtr vert = m_mesh.GetVerts()[queue.Pop().index].get();
+	auto& vertItem = m_context.m_verts[vert->GetIndex()];
+	vertItem.closedIteration = m_iteration;
+	m_currentVert = vert;
+
+	const double length = vertItem.done.length;
+	ExpandVert(vert, length);
 }
 
+void PathFinder::EndIteration()
+{
+	auto& queue = m_context.m_queue;
+	auto& incons = m_context.m_incons;
+
+	if (m_path.empty()) // Everything reachable has been seen.
+	{
+		m_length = 0;
+		m_isFinished = true;
+		return;
+	}
+
+	for (auto& item : queue.GetItems())
+		incons.push_back(item.index);
+
+	// Bound from the shortest path that might still be found.
+	double minLength = std::numeric_limits<double>::max();
+	for (int index : incons)
+	{
+		const auto& vertItem = m_context.m_verts[index];
+		minLength = std::min(minLength, vertItem.done.length + vertItem.hLength);
+	}
+
+	m_bound = std::max(1.0, std::min(m_weight, m_length / minLength));
+	if (m_weight <= 1 || m_bound <= 1)
+	{
+		m_bound = 1;
+		m_isFinished = true;
+		return;
+	}
+
+	m_weight = std::max(1.0, m_weight - m_options.weightStep);
+	++m_iteration;
+
+	queue.Reset(m_mesh.GetVerts().size());
+	for (int index : incons)
+	{
+		const auto& vertItem = m_context.m_verts[index];
+		if (!queue.Contains(index))
+			queue.Push(index, vertItem.done.length + m_weight * vertItem.hLength);
+	}
+	incons.clear();
+}
@@ -1,35 +1,52 @@
 #pragma once
 
 #include "EdgeMesh.h"
+#include "IndexedHeap.h"
 
 #include <functional>
 #include <map>
-#include <queue>
+#include <memory>
 #include <vector>
 
 namespace Jig
 {
 	
+	class Landmarks;
+	class Obstacles;
+	class VisibilityGraph;
+
 	class PathFinder
 	{
 	public:
-		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint);
-		~PathFinder();
-
-		using VertPtr = const EdgeMesh::Vert*;
+		class Context;
 
-		struct QueueItem
+		struct Options
 		{
-			bool operator <(const QueueItem& rhs) const
-			{
-				return std::make_tuple(gLength + hLength, vert, prev) > std::make_tuple(rhs.gLength + rhs.hLength, rhs.vert, prev); // Reverse sort. 
-			}
+			const Landmarks* landmarks = nullptr; // Tighter heuristic for maze-like meshes. Must outlive this.
+			bool bidirectional = false; // Also search back from the end point. Fewer verts for long paths.
+			const Obstacles* obstacles = nullptr; // Blocked verts, links and circles to avoid. Must outlive this.
+			const VisibilityGraph* graph = nullptr; // Walk this instead of the per-vert visible lists. Must outlive this.
 
-			double gLength; // Along path to start.
-			double hLength; // Straight line to end.
-			VertPtr vert, prev; // prev is only used to avoid sorting collisions. 
+			// Weighted A*: > 1 trades length for fewer verts, the path is at most weight times optimal.
+			// Anytime (ARA*): after each path, lower weight by weightStep (> 0) and keep improving it.
+			// Not with bidirectional.
+			double weight = 1;
+			bool anytime = false;
+			double weightStep = 0.2;
 		};
 
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint);
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint, Context& context); // context must outlive this.
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint, const Options& options);
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2& endPoint, const Options& options, Context& context);
+
+		// Path to whichever end point is nearest by path length. Not with bidirectional.
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const std::vector<Vec2>& endPoints, const Options& options);
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const std::vector<Vec2>& endPoints, const Options& options, Context& context);
+		~PathFinder();
+
+		using VertPtr = const EdgeMesh::Vert*;
+
 		struct DoneItem
 		{
 			double length; // Along path to start.
@@ -38,37 +55,118 @@ namespace Jig
 
 		typedef std::vector<Vec2> Path;
 		typedef std::map<VertPtr, DoneItem> DoneMap;
-		
-		class Queue : public std::priority_queue<QueueItem>
+		struct Request
+		{
+			Vec2 startPoint, endPoint;
+		};
+
+		struct Result
+		{
+			Path path; // Empty if there's no path.
+			double length{};
+		};
+
+		typedef IndexedHeap<double> Queue; // Vert index, keyed by estimated total length.
+		typedef Queue::Item QueueItem;
+
+		// Search state indexed by EdgeMesh::Vert::GetIndex(). Reuse one per thread to avoid allocating per query.
+		class Context
 		{
 		public:
-			const container_type& GetContainer() const { return c; }
+			Context() = default;
+			Context(const Context&) = delete;
+			Context& operator=(const Context&) = delete;
+
+		private:
+			friend class PathFinder;
+
+			struct VertItem
+			{
+				DoneItem done;
+				double hLength{}; // Lower bound to nearest end point.
+				unsigned doneGeneration{}; // done is valid if this matches m_generation.
+				unsigned endGeneration{}; // Visible from an end point if this matches m_generation.
+				double endLength{}; // Straight line to the nearest end point it can see, valid if endGeneration matches.
+				size_t endIndex{};
+
+				// Bidirectional search back from the end point.
+				DoneItem backDone; // Length along path to end, prev towards end.
+				double backHLength{}; // Lower bound to start point.
+				unsigned backDoneGeneration{};
+
+				// Anytime search, valid if doneGeneration matches.
+				unsigned closedIteration{}; // Expanded in this iteration.
+				unsigned inconsIteration{}; // Improved after being expanded - queued for the next iteration.
+			};
+
+			void Reset(size_t vertCount);
+
+			std::vector<VertItem> m_verts;
+			unsigned m_generation{};
+			Queue m_queue, m_backQueue;
+			std::vector<VertPtr> m_startVisible, m_endVisible;
+			std::vector<double> m_landmarkEndLengths, m_landmarkStartLengths;
+			std::vector<double> m_landmarkLengths; // One end point's, before taking the min into m_landmarkEndLengths.
+			std::vector<Vec2> m_endPoints; // Copied from the caller's.
+			std::vector<int> m_incons;
 		};
 
 		bool IsFinished() const { return m_isFinished; }
 
-		Path GetPath() const;
+		Path GetPath() const; // Anytime: best path so far, empty until one is found.
+		void GetPathVerts(std::vector<VertPtr>& verts) const; // Verts the finished path turns at, end first. Not anytime. Reuses verts' storage.
 		double GetLength() const { return m_length; }
+		double GetBound() const { return m_bound; } // Path is at most this times optimal.
+		size_t GetEndIndex() const { return m_endIndex; } // End point the path leads to.
 
-		const Queue::container_type& GetQueue() const { return m_queue.GetContainer(); }
-		const DoneMap & GetDone() const { return m_done; }
+		const std::vector<QueueItem>& GetQueue() const { return m_context.m_queue.GetItems(); }
+		DoneMap GetDone() const; // For debugging - builds a map.
 
 		void Go();
 		void Step();
 
+		// Runs Go() for each request on ThreadPool::GetDefault(), with a context per thread.
+		static void SolveBatch(const EdgeMesh& mesh, const std::vector<Request>& requests, std::vector<Result>& results);
+		static void SolveBatch(const EdgeMesh& mesh, const std::vector<Request>& requests, const Options& options, std::vector<Result>& results);
+
 	private:
+		PathFinder(const EdgeMesh& mesh, const Vec2& startPoint, const Vec2* endPoints, size_t endPointCount, const Options& options, Context* context);
+
+		void Init();
+		const Vec2& GetEndPoint(size_t i) const { return m_context.m_endPoints[i]; }
+		size_t GetEndPointCount() const { return m_context.m_endPoints.size(); }
 		void AppendPathToStart(VertPtr vert, PathFinder::Path& path) const;
-		void AddVert(VertPtr vert, VertPtr prev, double prevLength);
+		bool IsBlocked(const Vec2& point0, const Vec2& point1) const;
+		bool IsBlocked(VertPtr vert, VertPtr prev, const Vec2& point) const; // null prev means from point.
+		void ExpandVert(VertPtr vert, double length);
+		void ExpandBackVert(VertPtr vert, double length);
+		void AddVert(VertPtr vert, VertPtr prev, double length); // Length along path to start.
+		void AddBackVert(VertPtr vert, VertPtr prev, double length); // Length along path to end.
+		void InitHLengths(VertPtr vert, Context::VertItem& vertItem) const;
+		void SetEnd(VertPtr vert, size_t endIndex, double length);
+		void Finish();
+		double GetForwardPotential(const Context::VertItem& vertItem) const;
+		void StepBidirectional();
+		void FinishBidirectional();
+		void StepAnytime();
+		void EndIteration();
+		const DoneItem* FindDone(VertPtr vert) const;
 
 		const EdgeMesh& m_mesh;
-		const Vec2 m_startPoint, m_endPoint;
+		const Vec2 m_startPoint;
+		Vec2 m_endPoint; // Of the best path so far.
+		size_t m_endIndex;
+		const Options m_options;
 		bool m_isFinished;
 		Path m_path;
 		double m_length;
 		VertPtr m_currentVert;
-		
-		Queue m_queue;
-		DoneMap m_done;
-		std::set<VertPtr> m_endVisibleSet;
+		VertPtr m_meetVert; // Best vert to finish at so far: reached from both ends, or visible from an end point. Null if straight from start.
+		double m_meetLength;
+		double m_weight, m_bound;
+		unsigned m_iteration; // Anytime.
+
+		std::unique_ptr<Context> m_ownContext;
+		Context& m_context;
 	};
 }
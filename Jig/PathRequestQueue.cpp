@@ -0,0 +1,178 @@
+#include "PathRequestQueue.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace Jig;
+
+PathRequestQueue::PathRequestQueue(const EdgeMesh& mesh, int sliceSteps) : m_mesh(mesh), m_sliceSteps(std::max(1, sliceSteps)), m_nextID(1)
+{
+}
+
+PathRequestQueue::~PathRequestQueue()
+{
+}
+
+PathRequestQueue::ID PathRequestQueue::Add(const Vec2& startPoint, const Vec2& endPoint, int priority)
+{
+	const ID id = m_nextID++;
+
+	auto it = std::find_if(m_active.begin(), m_active.end(), [&](const JobPtr& job)
+	{
+		return job->startPoint == startPoint && job->endPoint == endPoint;
+	});
+
+	if (it != m_active.end()) // Share the existing search.
+	{
+		JobPtr job = *it;
+		++job->refCount;
+		m_requests[id] = job;
+
+		if (priority > job->priority) // Move up to the end of its new tier.
+		{
+			job->priority = priority;
+			m_active.erase(it);
+			auto pos = std::find_if(m_active.begin(), m_active.end(), [&](const JobPtr& j) { return j->priority < priority; });
+			m_active.insert(pos, job);
+		}
+		return id;
+	}
+
+	auto job = std::make_shared<Job>();
+	job->startPoint = startPoint;
+	job->endPoint = endPoint;
+	job->priority = priority;
+	job->refCount = 1;
+	job->finished = false;
+
+	auto pos = std::find_if(m_active.begin(), m_active.end(), [&](const JobPtr& j) { return j->priority < priority; });
+	m_active.insert(pos, job);
+	m_requests[id] = job;
+
+	return id;
+}
+
+void PathRequestQueue::Cancel(ID id)
+{
+	auto it = m_requests.find(id);
+	if (it == m_requests.end())
+		return;
+
+	JobPtr job = it->second;
+	m_requests.erase(it);
+
+	if (--job->refCount == 0 && !job->finished)
+	{
+		m_active.erase(std::find(m_active.begin(), m_active.end(), job));
+		Release(*job);
+	}
+}
+
+PathRequestQueue::Status PathRequestQueue::GetStatus(ID id) const
+{
+	auto it = m_requests.find(id);
+	if (it == m_requests.end())
+		return Status::None;
+
+	return it->second->finished ? Status::Finished : Status::Pending;
+}
+
+const PathFinder::Result* PathRequestQueue::GetResult(ID id) const
+{
+	auto it = m_requests.find(id);
+	if (it == m_requests.end() || !it->second->finished)
+		return nullptr;
+
+	return &it->second->result;
+}
+
+void PathRequestQueue::Clear()
+{
+	for (auto& job : m_active)
+		Release(*job);
+
+	m_active.clear();
+	m_requests.clear();
+}
+
+void PathRequestQueue::Update(const Budget& budget)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto startTime = Clock::now();
+	int steps = 0;
+
+	auto isOverBudget = [&]
+	{
+		if (budget.maxSteps > 0 && steps >= budget.maxSteps)
+			return true;
+
+		return budget.maxMicroseconds > 0 && std::chrono::duration<double, std::micro>(Clock::now() - startTime).count() >= budget.maxMicroseconds;
+	};
+
+	while (!m_active.empty() && !isOverBudget())
+	{
+		const JobPtr job = m_active.front();
+
+		int maxSteps = m_sliceSteps;
+		if (budget.maxSteps > 0)
+			maxSteps = std::min(maxSteps, budget.maxSteps - steps);
+
+		if (StepJob(*job, maxSteps, steps))
+		{
+			Finish(*job);
+			m_active.erase(m_active.begin());
+		}
+		else // Round robin: move to the back of its tier.
+		{
+			auto tierEnd = std::find_if(m_active.begin() + 1, m_active.end(), [&](const JobPtr& j) { return j->priority < job->priority; });
+			std::rotate(m_active.begin(), m_active.begin() + 1, tierEnd);
+		}
+	}
+}
+
+bool PathRequestQueue::StepJob(Job& job, int maxSteps, int& steps)
+{
+	int sliceSteps = 0;
+
+	if (!job.pathFinder) // Construction does the endpoint visibility queries, so count it as a step.
+	{
+		job.context = TakeContext();
+		job.pathFinder = std::make_unique<PathFinder>(m_mesh, job.startPoint, job.endPoint, *job.context);
+		++sliceSteps;
+	}
+
+	for (; sliceSteps < maxSteps && !job.pathFinder->IsFinished(); ++sliceSteps)
+		job.pathFinder->Step();
+
+	steps += sliceSteps;
+	return job.pathFinder->IsFinished();
+}
+
+void PathRequestQueue::Finish(Job& job)
+{
+	job.result.path = job.pathFinder->GetPath();
+	job.result.length = job.pathFinder->GetLength();
+	job.finished = true;
+
+	Release(job);
+}
+
+void PathRequestQueue::Release(Job& job)
+{
+	job.pathFinder.reset();
+
+	if (job.context)
+		m_freeContexts.push_back(std::move(job.context));
+}
+
+std::unique_ptr<PathFinder::Context> PathRequestQueue::TakeContext()
+{
+	if (m_freeContexts.empty())
+		return std::make_unique<PathFinder::Context>();
+
+	auto context = std::move(m_freeContexts.back());
+	m_freeContexts.pop_back();
+	return context;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "PathFinder.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Jig
+{
+	// Runs many PathFinders incrementally, a slice of steps at a time, within a per-update budget.
+	// Identical pending requests share one search.
+	class PathRequestQueue
+	{
+	public:
+		using ID = unsigned; // 0 is never used.
+
+		enum class Status { None, Pending, Finished };
+
+		struct Budget
+		{
+			int maxSteps; // PathFinder::Step() calls, <= 0 for no limit.
+			double maxMicroseconds; // <= 0 for no limit.
+		};
+
+		PathRequestQueue(const EdgeMesh& mesh, int sliceSteps = 32);
+		~PathRequestQueue();
+
+		ID Add(const Vec2& startPoint, const Vec2& endPoint, int priority = 0); // Higher priority is served first.
+		void Cancel(ID id); // Also releases finished results.
+
+		Status GetStatus(ID id) const;
+		const PathFinder::Result* GetResult(ID id) const; // Null until finished.
+
+		size_t GetPendingCount() const { return m_active.size(); }
+
+		void Update(const Budget& budget);
+
+		void Clear(); // Call if the mesh or its visibility changes.
+
+	private:
+		struct Job
+		{
+			Vec2 startPoint, endPoint;
+			int priority;
+			unsigned refCount;
+			std::unique_ptr<PathFinder::Context> context;
+			std::unique_ptr<PathFinder> pathFinder;
+			PathFinder::Result result;
+			bool finished;
+		};
+		using JobPtr = std::shared_ptr<Job>;
+
+		bool StepJob(Job& job, int maxSteps, int& steps); // Returns true if finished.
+		void Finish(Job& job);
+		void Release(Job& job); // Frees search state for reuse.
+		std::unique_ptr<PathFinder::Context> TakeContext();
+
+		const EdgeMesh& m_mesh;
+		const int m_sliceSteps;
+		ID m_nextID;
+
+		std::map<ID, JobPtr> m_requests;
+		std::vector<JobPtr> m_active; // Ordered by priority, then service order.
+		std::vector<std::unique_ptr<PathFinder::Context>> m_freeContexts;
+	};
+}
@@ -0,0 +1,143 @@
+#include "PathTable.h"
+#include "EdgeMeshVisibility.h"
+#include "GetVisiblePoints.h"
+#include "ThreadPool.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <limits>
+
+using namespace Jig;
+
+PathTable::PathTable(const EdgeMesh& mesh) : m_mesh(mesh), m_vertCount(0)
+{
+}
+
+PathTable::~PathTable()
+{
+}
+
+void PathTable::Build()
+{
+	Build(ThreadPool::GetDefault());
+}
+
+// Dijkstra back from each end vert. Visibility is mutual, so the way back is the way there.
+void PathTable::Build(ThreadPool& threadPool)
+{
+	const auto& verts = m_mesh.GetVerts();
+	KERNEL_ASSERT(verts.size() < NoVert && EdgeMeshVisibility::HasData(m_mesh));
+
+	m_vertCount = verts.size();
+	m_next.assign(m_vertCount * m_vertCount, NoVert);
+	m_lengths.assign(m_vertCount * m_vertCount, FLT_MAX);
+
+	threadPool.ParallelFor(m_vertCount, [&](size_t end)
+	{
+		std::vector<double> lengths(m_vertCount, std::numeric_limits<double>::max());
+		IndexedHeap<double> queue;
+		queue.Reset(m_vertCount);
+
+		uint16_t* next = &m_next[end * m_vertCount];
+		lengths[end] = 0;
+		next[end] = (uint16_t)end;
+		queue.Push((int)end, 0);
+
+		while (!queue.IsEmpty())
+		{
+			const auto top = queue.Pop();
+			const EdgeMesh::Vert& vert = *verts[top.index];
+
+			for (auto* other : EdgeMeshVisibility::GetData(&vert)->visible)
+			{
+				const double length = top.key + Vec2(*other - vert).GetLength();
+				if (length < lengths[other->GetIndex()])
+				{
+					lengths[other->GetIndex()] = length;
+					next[other->GetIndex()] = (uint16_t)top.index;
+					queue.PushOrDecrease(other->GetIndex(), length);
+				}
+			}
+		}
+
+		for (size_t i = 0; i < m_vertCount; ++i)
+			if (next[i] != NoVert)
+				m_lengths[end * m_vertCount + i] = (float)lengths[i];
+	});
+}
+
+void PathTable::Save(Kernel::Serial::SaveNode& node) const
+{
+	node.SaveType("vert_count", m_vertCount);
+	node.SaveCntr("next", m_next, Kernel::Serial::TypeSaver());
+	node.SaveCntr("lengths", m_lengths, Kernel::Serial::TypeSaver());
+}
+
+void PathTable::Load(const Kernel::Serial::LoadNode& node)
+{
+	node.LoadType("vert_count", m_vertCount);
+	node.LoadCntr("next", m_next, Kernel::Serial::TypeLoader());
+	node.LoadCntr("lengths", m_lengths, Kernel::Serial::TypeLoader());
+
+	KERNEL_ASSERT(m_next.size() == m_vertCount * m_vertCount && m_lengths.size() == m_next.size());
+}
+
+bool PathTable::GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length) const
+{
+	KERNEL_ASSERT(IsValid());
+	path.clear();
+
+	if (IsVisible(m_mesh, startPoint, endPoint))
+		path = { endPoint, startPoint };
+	else
+	{
+		const auto startVisible = GetVisiblePoints(m_mesh, startPoint);
+		const auto endVisible = GetVisiblePoints(m_mesh, endPoint);
+
+		std::vector<double> endLengths(endVisible.size());
+		for (size_t i = 0; i < endVisible.size(); ++i)
+			endLengths[i] = Vec2(endPoint - *endVisible[i]).GetLength();
+
+		double bestLength = std::numeric_limits<double>::max();
+		int bestStart = -1, bestEnd = -1;
+		for (auto* startVert : startVisible)
+		{
+			const double startLength = Vec2(*startVert - startPoint).GetLength();
+			for (size_t i = 0; i < endVisible.size(); ++i)
+			{
+				const float tableLength = m_lengths[endVisible[i]->GetIndex() * m_vertCount + startVert->GetIndex()];
+				if (tableLength == FLT_MAX)
+					continue;
+
+				const double totalLength = startLength + tableLength + endLengths[i];
+				if (totalLength < bestLength)
+				{
+					bestLength = totalLength;
+					bestStart = startVert->GetIndex();
+					bestEnd = endVisible[i]->GetIndex();
+				}
+			}
+		}
+
+		if (bestStart < 0)
+			return false;
+
+		path.push_back(startPoint);
+		for (int vert = bestStart; vert != bestEnd; vert = m_next[bestEnd * m_vertCount + vert])
+			path.push_back(*m_mesh.GetVerts()[vert]);
+		path.push_back(*m_mesh.GetVerts()[bestEnd]);
+		path.push_back(endPoint);
+
+		std::reverse(path.begin(), path.end());
+	}
+
+	if (length) // Table lengths are rounded, so add up the real ones.
+	{
+		*length = 0;
+		for (size_t i = 1; i < path.size(); ++i)
+			*length += Vec2(path[i] - path[i - 1]).GetLength();
+	}
+	return true;
+}
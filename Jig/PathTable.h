@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PathFinder.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Jig
+{
+	class ThreadPool;
+
+	// All-pairs shortest paths over the EdgeMeshVisibility graph, as next-hop vert indices, for small
+	// meshes that don't change. Queries only need the end points' visible verts and a table walk.
+	// Memory is 6 bytes per pair of verts, so keep to a few thousand verts.
+	class PathTable
+	{
+	public:
+		PathTable(const EdgeMesh& mesh); // Empty until Build() or Load().
+		~PathTable();
+
+		void Build();
+		void Build(ThreadPool& threadPool);
+
+		void Save(Kernel::Serial::SaveNode& node) const;
+		void Load(const Kernel::Serial::LoadNode& node);
+
+		bool IsValid() const { return m_vertCount && m_vertCount == m_mesh.GetVerts().size(); } // False if the mesh has changed size.
+
+		// Same order as PathFinder::GetPath(): end first. Returns false if end can't be reached.
+		bool GetPath(const Vec2& startPoint, const Vec2& endPoint, PathFinder::Path& path, double* length = nullptr) const;
+
+	private:
+		static constexpr uint16_t NoVert = 0xffff;
+
+		const EdgeMesh& m_mesh;
+		size_t m_vertCount;
+		std::vector<uint16_t> m_next; // By end vert, then vert: next vert towards end.
+		std::vector<float> m_lengths; // Same layout. Max if unreachable.
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "Geometry.h"
 #include "Line2.h"
+#include "Predicates.h"
 #include "Vector.h"
 
 #include "libKernel/Serial.h"
@@ -20,11 +21,13 @@ bool PolyLine::IsCW() const
 {
 	KERNEL_ASSERT(m_isClosed);
 
-	double total = 0.f;
-	for (int i = 0; i < (int)size(); ++i)
-		total += GetAngle(i);
+	// Twice the signed area, as a fan of triangles from the first vert: positive if the turns add up to
+	// a full anticlockwise turn.
+	double area = 0;
+	for (int i = 1; i + 1 < (int)size(); ++i)
+		area += Predicates::Orient(front(), at(i), at(i + 1));
 
-	return total > 0;
+	return area > 0;
 }
 
 void PolyLine::MakeCW()
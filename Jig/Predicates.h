@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Vector.h"
+
+namespace Jig
+{
+	// Orientation and angle-order tests on raw cross and dot products, for code that only compares
+	// directions. No sqrt or acos, and vectors needn't be normalised. Angles are as Vec2::GetAngle(),
+	// in (-pi, pi]: a half turn counts as anticlockwise. Zero vectors count as no turn.
+	namespace Predicates
+	{
+		// >0 if c is left of a->b, <0 if right, 0 if collinear. Twice the triangle's signed area.
+		inline double Orient(const Vec2& a, const Vec2& b, const Vec2& c)
+		{
+			return Vec2(b - a).DotSine(c - a);
+		}
+
+		// 1 if to is anticlockwise of from, -1 if clockwise, 0 if in line either way. For sweeps through faces,
+		// which can be concave, where a vector exactly behind isn't past a limit.
+		inline int GetSide(const Vec2& from, const Vec2& to)
+		{
+			const double sine = from.DotSine(to);
+			return sine > 0 ? 1 : sine < 0 ? -1 : 0;
+		}
+
+		// Sign of from.GetAngle(to): 1 if anticlockwise or a half turn, -1 if clockwise, 0 if the same direction.
+		inline int GetTurn(const Vec2& from, const Vec2& to)
+		{
+			const double sine = from.DotSine(to);
+			if (sine != 0)
+				return sine > 0 ? 1 : -1;
+			return from.Dot(to) < 0 ? 1 : 0;
+		}
+
+		// Compares from.GetAngle(a) with from.GetAngle(b): -1 if less, 0 if equal, 1 if greater.
+		inline int CompareAngles(const Vec2& from, const Vec2& a, const Vec2& b)
+		{
+			const int turnA = GetTurn(from, a), turnB = GetTurn(from, b);
+			if (turnA != turnB)
+				return turnA < turnB ? -1 : 1;
+			if (turnA == 0)
+				return 0;
+
+			// Both in the same half turn, so b's angle is greater if it's anticlockwise of a.
+			const double sine = a.DotSine(b);
+			return sine > 0 ? -1 : sine < 0 ? 1 : 0;
+		}
+
+		// vec is in the anticlockwise sector from limit0 to limit1, which is less than a half turn. Limits count.
+		inline bool IsInSector(const Vec2& vec, const Vec2& limit0, const Vec2& limit1)
+		{
+			return limit0.DotSine(vec) >= 0 && vec.DotSine(limit1) >= 0;
+		}
+	}
+}
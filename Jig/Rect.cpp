@@ -23,6 +23,11 @@ bool Rect::Contains(const Vec2& p) const
 	return p.x >= m_p0.x && p.x <= m_p1.x && p.y >= m_p0.y && p.y <= m_p1.y;
 }
 
+bool Rect::Intersects(const Rect& r) const
+{
+	return r.m_p0.x <= m_p1.x && r.m_p1.x >= m_p0.x && r.m_p0.y <= m_p1.y && r.m_p1.y >= m_p0.y;
+}
+
 void Rect::Normalise()
 {
 	if (m_p0.x > m_p1.x)
@@ -16,6 +16,7 @@ namespace Jig
 		double Height() const { return m_p1.y - m_p0.y; }
 		Vec2 GetCentre() const { return Vec2(m_p0.x + (m_p1.x - m_p0.x) / 2, m_p0.y + (m_p1.y - m_p0.y) / 2); }
 		bool Contains(const Vec2& point) const;
+		bool Intersects(const Rect& rect) const; // Touching counts.
 		bool IsEmpty() const { return m_p0 == m_p1; }
 
 		void Normalise();
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace Jig;
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned i = 1; i < threadCount; ++i) // The caller is the first thread.
+		m_threads.emplace_back(&ThreadPool::ThreadMain, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_startCondition.notify_all();
+
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+ThreadPool& ThreadPool::GetDefault()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn)
+{
+	if (count == 0)
+		return;
+
+	if (m_threads.empty() || count == 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+			fn(i);
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(m_runMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_fn = &fn;
+		m_count = count;
+		m_next = 0;
+		m_busyCount = (unsigned)m_threads.size();
+		++m_jobID;
+	}
+	m_startCondition.notify_all();
+
+	Work();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [&] { return m_busyCount == 0; });
+	m_fn = nullptr;
+}
+
+void ThreadPool::Work()
+{
+	for (size_t i = m_next++; i < m_count; i = m_next++)
+		(*m_fn)(i);
+}
+
+void ThreadPool::ThreadMain()
+{
+	unsigned jobID = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_startCondition.wait(lock, [&] { return m_quit || m_jobID != jobID; });
+			if (m_quit)
+				return;
+			jobID = m_jobID;
+		}
+
+		Work();
+
+		bool done = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			done = --m_busyCount == 0;
+		}
+		if (done)
+			m_doneCondition.notify_one();
+	}
+}
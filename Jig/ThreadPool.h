@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Jig
+{
+	// Persistent worker threads for data-parallel loops. Workers (and the calling thread) claim indices
+	// from a shared counter, so uneven items balance themselves out.
+	// Not reentrant: don't call ParallelFor from inside fn.
+	class ThreadPool
+	{
+	public:
+		ThreadPool(unsigned threadCount = 0); // 0: one per hardware thread, including the caller.
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		unsigned GetThreadCount() const { return (unsigned)m_threads.size() + 1; }
+
+		// Calls fn(i) for each i in [0, count) and waits for them all.
+		void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+		static ThreadPool& GetDefault();
+
+	private:
+		void ThreadMain();
+		void Work();
+
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_runMutex; // Serialises ParallelFor callers.
+		std::mutex m_mutex;
+		std::condition_variable m_startCondition, m_doneCondition;
+
+		const std::function<void(size_t)>* m_fn{};
+		size_t m_count{};
+		std::atomic<size_t> m_next{};
+		unsigned m_jobID{};
+		unsigned m_busyCount{};
+		bool m_quit{};
+	};
+}
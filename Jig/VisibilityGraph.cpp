@@ -0,0 +1,39 @@
+#include "VisibilityGraph.h"
+#include "EdgeMeshVisibility.h"
+
+#include "libKernel/Debug.h"
+
+using namespace Jig;
+
+VisibilityGraph::VisibilityGraph(const EdgeMesh& mesh, bool storeLengths) : m_version(mesh.GetVersion())
+{
+	KERNEL_ASSERT(EdgeMeshVisibility::HasData(mesh));
+
+	const auto& verts = mesh.GetVerts();
+
+	m_offsets.reserve(verts.size() + 1);
+	m_offsets.push_back(0);
+	for (auto& v : verts)
+		m_offsets.push_back(m_offsets.back() + (uint32_t)EdgeMeshVisibility::GetData(v.get())->visible.size());
+
+	m_links.reserve(m_offsets.back());
+	if (storeLengths)
+		m_lengths.reserve(m_offsets.back());
+
+	for (auto& v : verts)
+		for (auto* other : EdgeMeshVisibility::GetData(v.get())->visible)
+		{
+			m_links.push_back(other->GetIndex());
+			if (storeLengths)
+				m_lengths.push_back(Vec2(*other - *v).GetLength());
+		}
+}
+
+VisibilityGraph::~VisibilityGraph()
+{
+}
+
+size_t VisibilityGraph::GetMemorySize() const
+{
+	return m_offsets.capacity() * sizeof(uint32_t) + m_links.capacity() * sizeof(uint32_t) + m_lengths.capacity() * sizeof(double);
+}
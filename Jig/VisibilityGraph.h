@@ -0,0 +1,46 @@
+#pragma once
+
+#include "EdgeMesh.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Jig
+{
+	// Compact copy of the EdgeMeshVisibility graph: each vert's links are a contiguous slice of 32-bit
+	// vert indices, optionally with their lengths. Without lengths it's about a third the size of the per-vert
+	// lists, which can then be dropped with EdgeMeshVisibility::Clear() if only PathFinder needs them.
+	// Rebuild when the mesh changes.
+	class VisibilityGraph
+	{
+	public:
+		VisibilityGraph(const EdgeMesh& mesh, bool storeLengths = true); // Needs EdgeMeshVisibility.
+		~VisibilityGraph();
+
+		struct Links
+		{
+			const uint32_t* begin() const { return first; }
+			const uint32_t* end() const { return last; }
+			size_t size() const { return last - first; }
+
+			const uint32_t* first;
+			const uint32_t* last;
+		};
+
+		size_t GetVertCount() const { return m_offsets.size() - 1; }
+		size_t GetLinkCount() const { return m_links.size(); }
+		bool HasLengths() const { return !m_lengths.empty(); }
+		bool IsValid(const EdgeMesh& mesh) const { return mesh.GetVersion() == m_version; } // False if the mesh has changed.
+
+		Links GetLinks(size_t vert) const { return { m_links.data() + m_offsets[vert], m_links.data() + m_offsets[vert + 1] }; }
+		const double* GetLengths(size_t vert) const { return m_lengths.data() + m_offsets[vert]; } // Parallel to GetLinks(). Needs HasLengths().
+
+		size_t GetMemorySize() const; // Bytes.
+
+	private:
+		std::vector<uint32_t> m_offsets; // By vert index, plus one: links of vert are [m_offsets[vert], m_offsets[vert + 1]).
+		std::vector<uint32_t> m_links;
+		std::vector<double> m_lengths;
+		unsigned m_version;
+	};
+}
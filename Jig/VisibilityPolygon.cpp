@@ -0,0 +1,245 @@
+#include "VisibilityPolygon.h"
+#include "Predicates.h"
+#include "ThreadPool.h"
+
+#include "libKernel/Debug.h"
+
+#include <algorithm>
+
+using namespace Jig;
+
+namespace
+{
+	const double ArcStep = 2 * M_PI / 64; // Largest angle per chord.
+
+	// Stack item for the walk. Items from one face are pushed in reverse, so they're popped in edge
+	// order, and a face's items all come out before its next sibling's: the ring is built anticlockwise.
+	struct Item
+	{
+		enum class Type { OpenFace, Face, Wall, Arc };
+
+		Type type;
+		const EdgeMesh::Edge* edge; // OpenFace and Face: entering edge, null for the start face. Wall: the wall.
+		Vec2 limit0, limit1; // Anticlockwise, from point. Not used by OpenFace.
+	};
+
+	struct Scratch
+	{
+		std::vector<Item> stack;
+	};
+
+	Scratch& GetScratch()
+	{
+		thread_local Scratch scratch;
+		return scratch;
+	}
+
+	class RingBuilder
+	{
+	public:
+		RingBuilder(const Vec2& point, double maxRadius, Polygon& ring) : m_point(point), m_maxRadius(maxRadius), m_ring(ring) {}
+
+		void Add(const Vec2& p)
+		{
+			if (m_ring.empty() || !(m_ring.back() == p))
+				m_ring.push_back(p);
+		}
+
+		// At maxRadius, anticlockwise from direction vec0 to vec1, less than half a turn apart.
+		void AddArc(const Vec2& vec0, const Vec2& vec1)
+		{
+			Vec2 dir = vec0;
+			if (!dir.Normalise())
+				return;
+
+			const double angle = std::max(0.0, std::atan2(vec0.DotSine(vec1), vec0.Dot(vec1)));
+			const int steps = std::max(1, (int)std::ceil(angle / ArcStep));
+			for (int i = 0; i <= steps; ++i)
+			{
+				const double a = angle * i / steps, c = std::cos(a), s = std::sin(a);
+				Add(m_point + Vec2(dir.x * c - dir.y * s, dir.x * s + dir.y * c) * m_maxRadius);
+			}
+		}
+
+		// The part of a wall seen from p0 to p1, anticlockwise, cut off at maxRadius.
+		void AddWall(const Vec2& p0, const Vec2& p1)
+		{
+			if (m_maxRadius == std::numeric_limits<double>::infinity())
+			{
+				Add(p0);
+				Add(p1);
+				return;
+			}
+
+			// Solve |p0 + t(p1 - p0) - point| = maxRadius. Distance from point is convex along the wall,
+			// so the part within maxRadius is one interval of t.
+			const Vec2 from = p0 - m_point, vec = p1 - p0;
+			const double a = vec.GetLengthSquared(), b = 2 * from.Dot(vec), c = from.GetLengthSquared() - m_maxRadius * m_maxRadius;
+			const double disc = b * b - 4 * a * c;
+
+			if (a == 0 || disc < 0)
+			{
+				if (c <= 0)
+					Add(p0);
+				else
+					AddArc(from, p1 - m_point);
+				return;
+			}
+
+			const double root = std::sqrt(disc);
+			const double t0 = (-b - root) / (2 * a), t1 = (-b + root) / (2 * a);
+			if (t1 < 0 || t0 > 1)
+			{
+				AddArc(from, p1 - m_point); // All beyond maxRadius.
+				return;
+			}
+
+			const Vec2 q0 = t0 > 0 ? Vec2(p0 + vec * t0) : p0;
+			const Vec2 q1 = t1 < 1 ? Vec2(p0 + vec * t1) : p1;
+			if (t0 > 0)
+				AddArc(from, q0 - m_point);
+			Add(q0);
+			Add(q1);
+			if (t1 < 1)
+				AddArc(q1 - m_point, p1 - m_point);
+		}
+
+		bool IsBeyond(const EdgeMesh::Edge& edge) const // Whole edge is beyond maxRadius.
+		{
+			const Vec2 p0 = *edge.vert, vec = *edge.next->vert - p0;
+			const double lengthSquared = vec.GetLengthSquared();
+			const double t = lengthSquared > 0 ? std::min(1.0, std::max(0.0, Vec2(m_point - p0).Dot(vec) / lengthSquared)) : 0;
+			return Vec2(p0 + vec * t - m_point).GetLengthSquared() > m_maxRadius * m_maxRadius;
+		}
+
+		void Finish()
+		{
+			if (m_ring.size() > 1 && m_ring.front() == m_ring.back())
+				m_ring.pop_back();
+		}
+
+	private:
+		const Vec2 m_point;
+		const double m_maxRadius;
+		Polygon& m_ring;
+	};
+
+	// Where the ray from point along dir crosses the edge's line. dir must be in the edge's range.
+	Vec2 GetHit(const Vec2& point, const Vec2& dir, const EdgeMesh::Edge& edge)
+	{
+		const Vec2 p0 = *edge.vert, vec = *edge.next->vert - p0;
+		const double denom = dir.DotSine(vec);
+		if (denom == 0) // In line: the near end.
+			return Vec2(p0 - point).GetLengthSquared() < Vec2(*edge.next->vert - point).GetLengthSquared() ? p0 : *edge.next->vert;
+		return point + dir * (Vec2(p0 - point).DotSine(vec) / denom);
+	}
+
+	void PushOpenFaceItems(const EdgeMesh::Face& face, const EdgeMesh::Edge* enteringEdge, const Vec2& point, const RingBuilder& builder, std::vector<Item>& stack)
+	{
+		for (auto& edge : enteringEdge ? face.GetOtherEdges(*enteringEdge) : face.GetEdges())
+		{
+			const Vec2 limit0 = *edge.vert - point;
+			const Vec2 limit1 = *edge.next->vert - point;
+
+			if (!edge.twin)
+				stack.push_back({ Item::Type::Wall, &edge, limit0, limit1 });
+			else if (limit0.IsZero() || limit1.IsZero())
+				stack.push_back({ Item::Type::OpenFace, edge.twin, Vec2(), Vec2() }); // Point is on the edge - no need for limits.
+			else if (builder.IsBeyond(edge))
+				stack.push_back({ Item::Type::Arc, &edge, limit0, limit1 });
+			else
+				stack.push_back({ Item::Type::Face, edge.twin, limit0, limit1 });
+		}
+	}
+
+	// As the limited walk in GetVisiblePoints.cpp.
+	void PushFaceItems(const Item& item, const Vec2& point, const RingBuilder& builder, std::vector<Item>& stack)
+	{
+		const EdgeMesh::Edge& enteringEdge = *item.edge;
+
+		for (auto& edge : enteringEdge.face->GetOtherEdges(enteringEdge))
+		{
+			const Vec2 toStart = *edge.vert - point;
+			if (Predicates::GetSide(item.limit1, toStart) > 0) // Finished.
+				break;
+
+			const Vec2 toEnd = *edge.next->vert - point;
+			if (Predicates::GetSide(item.limit0, toEnd) < 0) // Not in range yet.
+				continue;
+
+			const Vec2 newLimit0 = Predicates::GetSide(item.limit0, toStart) >= 0 ? toStart : item.limit0;
+			const Vec2 newLimit1 = Predicates::GetSide(item.limit1, toEnd) < 0 ? toEnd : item.limit1;
+
+			if (!edge.twin)
+				stack.push_back({ Item::Type::Wall, &edge, newLimit0, newLimit1 });
+			else if (builder.IsBeyond(edge))
+				stack.push_back({ Item::Type::Arc, &edge, newLimit0, newLimit1 });
+			else
+				stack.push_back({ Item::Type::Face, edge.twin, newLimit0, newLimit1 });
+		}
+	}
+}
+
+Polygon Jig::ComputeVisibilityPolygon(const EdgeMesh& mesh, const Vec2& point, double maxRadius)
+{
+	Polygon ring;
+	ComputeVisibilityPolygon(mesh, point, maxRadius, ring);
+	return ring;
+}
+
+void Jig::ComputeVisibilityPolygon(const EdgeMesh& mesh, const Vec2& point, double maxRadius, Polygon& ring)
+{
+	KERNEL_ASSERT(maxRadius > 0);
+
+	ring.clear();
+	ring.SetClosed(true);
+
+	const EdgeMesh::Face* startFace = mesh.HitTest(point);
+	if (!startFace)
+		return;
+
+	RingBuilder builder(point, maxRadius, ring);
+	auto& stack = GetScratch().stack;
+	stack.clear();
+	stack.push_back({ Item::Type::OpenFace, nullptr, Vec2(), Vec2() });
+
+	while (!stack.empty())
+	{
+		const Item item = stack.back();
+		stack.pop_back();
+
+		const size_t first = stack.size();
+		switch (item.type)
+		{
+		case Item::Type::OpenFace:
+			PushOpenFaceItems(item.edge ? *item.edge->face : *startFace, item.edge, point, builder, stack);
+			break;
+		case Item::Type::Face:
+			PushFaceItems(item, point, builder, stack);
+			break;
+		case Item::Type::Wall:
+			{
+				const Vec2 p0 = Predicates::GetSide(item.limit0, *item.edge->vert - point) == 0 ? Vec2(*item.edge->vert) : GetHit(point, item.limit0, *item.edge);
+				const Vec2 p1 = Predicates::GetSide(item.limit1, *item.edge->next->vert - point) == 0 ? Vec2(*item.edge->next->vert) : GetHit(point, item.limit1, *item.edge);
+				builder.AddWall(p0, p1);
+			}
+			break;
+		case Item::Type::Arc:
+			builder.AddArc(item.limit0, item.limit1);
+			break;
+		}
+		std::reverse(stack.begin() + first, stack.end());
+	}
+
+	builder.Finish();
+}
+
+void Jig::ComputeVisibilityPolygons(const EdgeMesh& mesh, const std::vector<Vec2>& points, double maxRadius, std::vector<Polygon>& rings)
+{
+	rings.resize(points.size());
+
+	ThreadPool::GetDefault().ParallelFor(points.size(), [&](size_t i)
+	{
+		ComputeVisibilityPolygon(mesh, points[i], maxRadius, rings[i]);
+	});
+}
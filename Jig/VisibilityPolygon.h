@@ -0,0 +1,20 @@
+#pragma once
+
+#include "EdgeMesh.h"
+#include "Polygon.h"
+
+#include <limits>
+#include <vector>
+
+namespace Jig
+{
+	// The region visible from point, as an anticlockwise ring, found with the same walk through face edges as
+	// GetVisiblePoints(). Ring points are ordered by the walk, so there's no sort. Where maxRadius cuts
+	// the region off, the arc is approximated with chords of at most 1/64 turn. Empty if point isn't in mesh.
+	// As with GetVisiblePoints(), a point at a pinch vert only sees out of the fan of faces HitTest() finds.
+	Polygon ComputeVisibilityPolygon(const EdgeMesh& mesh, const Vec2& point, double maxRadius = std::numeric_limits<double>::infinity());
+	void ComputeVisibilityPolygon(const EdgeMesh& mesh, const Vec2& point, double maxRadius, Polygon& ring); // Reuses ring's storage.
+
+	// For several viewers, on ThreadPool::GetDefault(), with scratch per thread. Reuses rings' storage.
+	void ComputeVisibilityPolygons(const EdgeMesh& mesh, const std::vector<Vec2>& points, double maxRadius, std::vector<Polygon>& rings);
+}